@@ -0,0 +1,178 @@
+/*
+ * Micro-benchmarks for the commonly used API functions of every format.
+ *
+ * Each operation is run over a fixed corpus (the decode test vectors plus
+ * lengths and addresses from a fixed-seed generator) for a number of samples.
+ * One JSON object per format and operation is written to stdout with the
+ * median and 99th percentile time per operation across the samples and the
+ * resulting throughput.
+ *
+ * Usage: cc_bench [samples]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+#include "../cheri_compressed_cap.h"
+
+namespace inputs64 {
+#include "../test/decode_inputs_64.cpp"
+}
+namespace inputs128 {
+#include "../test/decode_inputs_128.cpp"
+}
+
+static volatile uint64_t sink;
+
+static uint64_t xorshift64(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+template <class Fmt> struct Corpus {
+    using addr_t = typename Fmt::addr_t;
+    using length_t = typename Fmt::length_t;
+    using cap_t = typename Fmt::cap_t;
+
+    std::vector<addr_t> pesbts;
+    std::vector<addr_t> cursors;
+    std::vector<cap_t> caps;         // decompress_mem(pesbts[i], cursors[i])
+    cap_t max_cap;                   // Maximum permission capability with address zero
+    std::vector<cap_t> bounds_caps;  // Maximum permission capabilities with a random address
+    std::vector<addr_t> lengths;     // Requested lengths spread over all exponents
+    std::vector<addr_t> new_addrs;   // Addresses near (and sometimes far from) caps[i]
+
+    template <class Input, size_t N> explicit Corpus(const Input (&inputs)[N]) {
+        const unsigned addr_width = std::numeric_limits<addr_t>::digits;
+        const length_t max_top = (length_t)std::numeric_limits<addr_t>::max() + 1;
+        uint64_t state = UINT64_C(0x9e3779b97f4a7c15);
+        max_cap = Fmt::make_max_perms_cap(0, 0, max_top);
+        for (const Input& input : inputs) {
+            pesbts.push_back((addr_t)input.pesbt);
+            cursors.push_back((addr_t)input.cursor);
+            caps.push_back(Fmt::decompress_mem(pesbts.back(), cursors.back(), false));
+            bounds_caps.push_back(Fmt::make_max_perms_cap(0, (addr_t)xorshift64(&state), max_top));
+            lengths.push_back((addr_t)xorshift64(&state) >> (xorshift64(&state) % addr_width));
+            addr_t delta = (addr_t)xorshift64(&state) >> (xorshift64(&state) % addr_width);
+            new_addrs.push_back(xorshift64(&state) & 1 ? input.cursor + delta : input.cursor - delta);
+        }
+    }
+    size_t size() const { return pesbts.size(); }
+};
+
+template <class Body>
+static void measure(const char* format, const char* op, size_t ops_per_sample, unsigned samples, Body body) {
+    using clock = std::chrono::steady_clock;
+    std::vector<double> ns_per_op(samples);
+    sink += body(); // warm up caches and branch predictors
+    for (unsigned i = 0; i < samples; i++) {
+        auto start = clock::now();
+        sink += body();
+        auto end = clock::now();
+        ns_per_op[i] = std::chrono::duration<double, std::nano>(end - start).count() / (double)ops_per_sample;
+    }
+    std::sort(ns_per_op.begin(), ns_per_op.end());
+    double median = ns_per_op[samples / 2];
+    double p99 = ns_per_op[std::min<size_t>(samples - 1, (size_t)(samples * 0.99))];
+    printf("{\"format\": \"%s\", \"op\": \"%s\", \"samples\": %u, \"ops_per_sample\": %zu, "
+           "\"median_ns_per_op\": %.3f, \"p99_ns_per_op\": %.3f, \"ops_per_sec\": %.0f}\n",
+           format, op, samples, ops_per_sample, median, p99, 1e9 / median);
+}
+
+template <class Fmt> static void bench_format(const char* format, const Corpus<Fmt>& corpus, unsigned samples) {
+    using cap_t = typename Fmt::cap_t;
+    const size_t n = corpus.size();
+    measure(format, "decompress_mem", n, samples, [&]() {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < n; i++) {
+            cap_t cap = Fmt::decompress_mem(corpus.pesbts[i], corpus.cursors[i], false);
+            sum += cap.cr_base + (uint64_t)cap._cr_top;
+        }
+        return sum;
+    });
+    measure(format, "compress_mem", n, samples, [&]() {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < n; i++)
+            sum += Fmt::compress_mem(corpus.caps[i]);
+        return sum;
+    });
+    measure(format, "setbounds", n, samples, [&]() {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < n; i++) {
+            cap_t cap = corpus.bounds_caps[i];
+            sum += Fmt::setbounds(&cap, corpus.lengths[i]);
+            sum += cap.cr_pesbt;
+        }
+        return sum;
+    });
+    // Same inputs as the setbounds benchmark above, but derived from a single parent.
+    std::vector<typename Fmt::addr_t> batch_bases;
+    for (const cap_t& cap : corpus.bounds_caps)
+        batch_bases.push_back(cap.address());
+    std::vector<typename Fmt::length_t> batch_lengths(corpus.lengths.begin(), corpus.lengths.end());
+    std::vector<cap_t> batch_out(n);
+    measure(format, "setbounds_batch", n, samples, [&]() {
+        Fmt::setbounds_batch(corpus.max_cap, batch_bases.data(), batch_lengths.data(), n, batch_out.data(),
+                             nullptr);
+        uint64_t sum = 0;
+        for (size_t i = 0; i < n; i++)
+            sum += batch_out[i].cr_pesbt;
+        return sum;
+    });
+    measure(format, "set_addr", n, samples, [&]() {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < n; i++) {
+            cap_t cap = corpus.caps[i];
+            Fmt::set_addr(&cap, corpus.new_addrs[i]);
+            sum += cap.cr_base + cap.cr_tag;
+        }
+        return sum;
+    });
+    measure(format, "fast_is_representable_new_addr", n, samples, [&]() {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < n; i++)
+            sum += Fmt::fast_is_representable_new_addr(corpus.caps[i], corpus.new_addrs[i]);
+        return sum;
+    });
+    measure(format, "precise_is_representable_new_addr", n, samples, [&]() {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < n; i++)
+            sum += Fmt::precise_is_representable_new_addr(corpus.caps[i], corpus.new_addrs[i]);
+        return sum;
+    });
+    measure(format, "get_representable_length", n, samples, [&]() {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < n; i++)
+            sum += Fmt::representable_length(corpus.lengths[i]);
+        return sum;
+    });
+    measure(format, "get_alignment_mask", n, samples, [&]() {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < n; i++)
+            sum += Fmt::representable_mask(corpus.lengths[i]);
+        return sum;
+    });
+}
+
+int main(int argc, char** argv) {
+    unsigned samples = argc > 1 ? (unsigned)strtoul(argv[1], nullptr, 0) : 101;
+    if (samples == 0) {
+        fprintf(stderr, "Usage: %s [samples]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    bench_format("64", Corpus<CompressedCap64>(inputs64::inputs), samples);
+    bench_format("64r", Corpus<CompressedCap64r>(inputs64::inputs), samples);
+    bench_format("128", Corpus<CompressedCap128>(inputs128::inputs), samples);
+    bench_format("128r", Corpus<CompressedCap128r>(inputs128::inputs), samples);
+    bench_format("128m", Corpus<CompressedCap128m>(inputs128::inputs), samples);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,76 @@
+/*
+ * Compares the default _cc_length_t bounds arithmetic against the
+ * _CC_SPLIT_LENGTH_ARITHMETIC mode for setbounds() and decompression.
+ *
+ * Usage: length_arith_bench [iterations]
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "length_arith_bench.h"
+
+#define NUM_INPUTS 4096
+
+typedef uint64_t (*length_arith_kernel)(const struct length_arith_input* inputs, size_t count);
+
+static uint64_t xorshift64(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static double time_kernel(length_arith_kernel kernel, const struct length_arith_input* inputs, unsigned iterations,
+                          uint64_t* checksum) {
+    double start = now_ns();
+    for (unsigned i = 0; i < iterations; i++)
+        *checksum += kernel(inputs, NUM_INPUTS);
+    return (now_ns() - start) / ((double)iterations * NUM_INPUTS);
+}
+
+static int compare(const char* name, length_arith_kernel native, length_arith_kernel split,
+                   const struct length_arith_input* inputs, unsigned iterations) {
+    uint64_t native_sum = 0, split_sum = 0;
+    double native_ns = time_kernel(native, inputs, iterations, &native_sum);
+    double split_ns = time_kernel(split, inputs, iterations, &split_sum);
+    printf("%-14s native %7.2f ns/op  split %7.2f ns/op  delta %+6.1f%%\n", name, native_ns, split_ns,
+           (split_ns - native_ns) / native_ns * 100.0);
+    if (native_sum != split_sum) {
+        fprintf(stderr, "%s: checksum mismatch (0x%" PRIx64 " vs 0x%" PRIx64 ")\n", name, native_sum, split_sum);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    unsigned iterations = argc > 1 ? (unsigned)strtoul(argv[1], NULL, 0) : 200;
+    static struct length_arith_input inputs[NUM_INPUTS];
+    uint64_t state = 0x9e3779b97f4a7c15;
+    for (size_t i = 0; i < NUM_INPUTS; i++) {
+        // Spread the lengths over all exponents and keep base + length within the address space.
+        inputs[i].base = xorshift64(&state);
+        inputs[i].length = xorshift64(&state) >> (xorshift64(&state) % 64);
+        if (inputs[i].length > UINT64_MAX - inputs[i].base)
+            inputs[i].length = UINT64_MAX - inputs[i].base;
+        inputs[i].pesbt = xorshift64(&state);
+    }
+    int result = 0;
+    result |= compare("setbounds 64", length_arith_setbounds_native_64, length_arith_setbounds_split_64, inputs,
+                      iterations);
+    result |= compare("setbounds 128", length_arith_setbounds_native_128, length_arith_setbounds_split_128, inputs,
+                      iterations);
+    result |= compare("decode 64", length_arith_decode_native_64, length_arith_decode_split_64, inputs, iterations);
+    result |= compare("decode 128", length_arith_decode_native_128, length_arith_decode_split_128, inputs,
+                      iterations);
+    return result;
+}
@@ -0,0 +1,28 @@
+#ifndef _LENGTH_ARITH_BENCH_H
+#define _LENGTH_ARITH_BENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * The kernels are compiled twice, once with the default _cc_length_t arithmetic
+ * and once with _CC_SPLIT_LENGTH_ARITHMETIC, so that both can be timed in the
+ * same binary. Each returns a checksum of the results so that the two variants
+ * can be checked against each other.
+ */
+struct length_arith_input {
+    uint64_t base;
+    uint64_t length;
+    uint64_t pesbt;
+};
+
+uint64_t length_arith_setbounds_native_64(const struct length_arith_input* inputs, size_t count);
+uint64_t length_arith_setbounds_split_64(const struct length_arith_input* inputs, size_t count);
+uint64_t length_arith_decode_native_64(const struct length_arith_input* inputs, size_t count);
+uint64_t length_arith_decode_split_64(const struct length_arith_input* inputs, size_t count);
+uint64_t length_arith_setbounds_native_128(const struct length_arith_input* inputs, size_t count);
+uint64_t length_arith_setbounds_split_128(const struct length_arith_input* inputs, size_t count);
+uint64_t length_arith_decode_native_128(const struct length_arith_input* inputs, size_t count);
+uint64_t length_arith_decode_split_128(const struct length_arith_input* inputs, size_t count);
+
+#endif
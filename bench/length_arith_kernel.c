@@ -0,0 +1,52 @@
+#include "length_arith_bench.h"
+#include "../cheri_compressed_cap.h"
+
+#ifndef LENGTH_ARITH_VARIANT
+#define LENGTH_ARITH_VARIANT native
+#endif
+#define LENGTH_ARITH_FN(op, format)                                                                                    \
+    _CC_CONCAT(_CC_CONCAT(length_arith_, op), _CC_CONCAT(_CC_CONCAT(_, LENGTH_ARITH_VARIANT), _CC_CONCAT(_, format)))
+
+// setbounds() goes through compute_ebt() and compute_base_top().
+uint64_t LENGTH_ARITH_FN(setbounds, 64)(const struct length_arith_input* inputs, size_t count) {
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < count; i++) {
+        cc64_cap_t cap = cc64_make_max_perms_cap(0, (cc64_addr_t)inputs[i].base, CC64_MAX_TOP);
+        bool exact = cc64_setbounds(&cap, (cc64_addr_t)inputs[i].length);
+        checksum = checksum * 31 + cap.cr_base + cap._cr_top + cap.cr_pesbt + exact;
+    }
+    return checksum;
+}
+
+uint64_t LENGTH_ARITH_FN(setbounds, 128)(const struct length_arith_input* inputs, size_t count) {
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < count; i++) {
+        cc128_cap_t cap = cc128_make_max_perms_cap(0, inputs[i].base, CC128_MAX_TOP);
+        bool exact = cc128_setbounds(&cap, inputs[i].length);
+        checksum = checksum * 31 + cap.cr_base + (uint64_t)(cap._cr_top >> 64) + (uint64_t)cap._cr_top +
+                   cap.cr_pesbt + exact;
+    }
+    return checksum;
+}
+
+// Decompression only needs compute_base_top().
+uint64_t LENGTH_ARITH_FN(decode, 64)(const struct length_arith_input* inputs, size_t count) {
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < count; i++) {
+        cc64_cap_t cap;
+        cc64_decompress_raw((cc64_addr_t)inputs[i].pesbt, (cc64_addr_t)inputs[i].base, true, &cap);
+        checksum = checksum * 31 + cap.cr_base + cap._cr_top + cap.cr_bounds_valid;
+    }
+    return checksum;
+}
+
+uint64_t LENGTH_ARITH_FN(decode, 128)(const struct length_arith_input* inputs, size_t count) {
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < count; i++) {
+        cc128_cap_t cap;
+        cc128_decompress_raw(inputs[i].pesbt, inputs[i].base, true, &cap);
+        checksum = checksum * 31 + cap.cr_base + (uint64_t)(cap._cr_top >> 64) + (uint64_t)cap._cr_top +
+                   cap.cr_bounds_valid;
+    }
+    return checksum;
+}
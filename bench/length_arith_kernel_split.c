@@ -0,0 +1,3 @@
+#define _CC_SPLIT_LENGTH_ARITHMETIC 1
+#define LENGTH_ARITH_VARIANT split
+#include "length_arith_kernel.c"
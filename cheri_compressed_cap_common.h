@@ -286,6 +286,50 @@ static inline uint32_t _cc_N(get_exponent)(_cc_length_t length) {
     }
 }
 
+#ifdef _CC_SPLIT_LENGTH_ARITHMETIC
+/*
+ * When _CC_SPLIT_LENGTH_ARITHMETIC is defined, compute_base_top() and compute_ebt() operate on base/top values
+ * split into the low address-sized word and bit _CC_ADDR_WIDTH instead of shifting and masking _cc_length_t.
+ * For the 128-bit formats _cc_length_t is unsigned __int128, and variable shifts of that type lower to long
+ * instruction sequences (or libgcc calls) on some hosts. The public API still uses _cc_length_t.
+ */
+struct _cc_N(length_parts) {
+    _cc_addr_t lo;
+    _cc_addr_t hi; // bit _CC_ADDR_WIDTH, always 0 or 1
+};
+
+static inline struct _cc_N(length_parts) _cc_N(length_split__)(_cc_length_t value) {
+    _cc_debug_assert((value >> _CC_ADDR_WIDTH) <= 1 && "value must fit in _CC_LEN_WIDTH bits");
+    struct _cc_N(length_parts) result;
+    result.lo = (_cc_addr_t)value;
+    result.hi = (_cc_addr_t)(value >> _CC_ADDR_WIDTH) & 1;
+    return result;
+}
+
+static inline _cc_length_t _cc_N(length_join__)(struct _cc_N(length_parts) value) {
+    return ((_cc_length_t)value.hi << _CC_ADDR_WIDTH) | value.lo;
+}
+
+/// Returns truncate(region @ mantissa @ zeros(E), _CC_LEN_WIDTH) without any _cc_length_t shifts.
+static inline struct _cc_N(length_parts) _cc_N(length_from_bounds_bits__)(_cc_addr_t region, _cc_addr_t mantissa,
+                                                                         unsigned E) {
+    const unsigned shift = E + _CC_MANTISSA_WIDTH;
+    struct _cc_N(length_parts) result;
+    result.lo = (shift < _CC_ADDR_WIDTH ? region << shift : 0) | (_cc_addr_t)(mantissa << E);
+    if (shift <= _CC_ADDR_WIDTH)
+        result.hi = (region >> (_CC_ADDR_WIDTH - shift)) & 1;
+    else
+        result.hi = (mantissa >> (_CC_ADDR_WIDTH - E)) & 1;
+    return result;
+}
+
+/// Returns truncate(value >> shift, _CC_ADDR_WIDTH) for 0 < shift < _CC_ADDR_WIDTH.
+static inline _cc_addr_t _cc_N(length_shr__)(struct _cc_N(length_parts) value, unsigned shift) {
+    _cc_debug_assert(shift > 0 && shift < _CC_ADDR_WIDTH);
+    return (value.lo >> shift) | (value.hi << (_CC_ADDR_WIDTH - shift));
+}
+#endif
+
 static inline uint64_t _cc_N(getbits)(uint64_t src, uint32_t start, uint32_t size) {
     return ((src >> start) & ((UINT64_C(1) << size) - UINT64_C(1)));
 }
@@ -518,6 +562,20 @@ static inline bool _cc_N(compute_base_top)(_cc_bounds_bits bounds, _cc_addr_t cu
     // let a_top = (a >> (E + mantissa_width)) in
     _cc_addr_t a_top = a_top_shift >= _CC_ADDR_WIDTH ? 0 : cursor >> a_top_shift;
 
+#ifdef _CC_SPLIT_LENGTH_ARITHMETIC
+    // Same computation as below, but with bit _CC_ADDR_WIDTH of base and top kept in a separate word.
+    struct _cc_N(length_parts) base_parts =
+        _cc_N(length_from_bounds_bits__)((_cc_addr_t)((int64_t)a_top + correction_base), bounds.B, E);
+    struct _cc_N(length_parts) top_parts =
+        _cc_N(length_from_bounds_bits__)((_cc_addr_t)((int64_t)a_top + correction_top), bounds.T, E);
+    unsigned base2 = (unsigned)(base_parts.lo >> (_CC_ADDR_WIDTH - 1)) & 1;
+    unsigned top2 = (unsigned)((top_parts.hi << 1) | ((top_parts.lo >> (_CC_ADDR_WIDTH - 1)) & 1));
+    if (E < (_CC_MAX_EXPONENT - 1) && (top2 - base2) > 1) {
+        top_parts.hi ^= 1;
+    }
+    _cc_length_t base = _cc_N(length_join__)(base_parts);
+    _cc_length_t top = _cc_N(length_join__)(top_parts);
+#else
     // base : CapLenBits = truncate((a_top + correction_base) @ c.B @ zeros(E), cap_len_width);
     _cc_length_t base = (_cc_addr_t)((int64_t)a_top + correction_base);
     base <<= _CC_MANTISSA_WIDTH;
@@ -548,6 +606,7 @@ static inline bool _cc_N(compute_base_top)(_cc_bounds_bits bounds, _cc_addr_t cu
     if (E < (_CC_MAX_EXPONENT - 1) && (top2 - base2) > 1) {
         top = top ^ ((_cc_length_t)1 << _CC_ADDR_WIDTH);
     }
+#endif
 
     _cc_debug_assert((_cc_addr_t)(top >> _CC_ADDR_WIDTH) <= 1); // should be at most 1 bit over
     // Check that base <= top for valid inputs
@@ -573,6 +632,126 @@ static inline bool _cc_N(compute_base_top)(_cc_bounds_bits bounds, _cc_addr_t cu
     return true;
 }
 
+/// Returns a if cond (which must be 0 or 1) is set and b otherwise, without branches or a conditional move.
+static inline _cc_addr_t _cc_N(lane_select__)(_cc_addr_t cond, _cc_addr_t a, _cc_addr_t b) {
+    _cc_addr_t mask = (_cc_addr_t)0 - cond;
+    return (a & mask) | (b & ~mask);
+}
+
+/*
+ * Branch-free equivalent of extract_bounds_bits() followed by compute_base_top() for a single capability, used as the
+ * loop body of the batch kernels below so that the compiler can vectorize it. Bit _CC_ADDR_WIDTH of top is returned
+ * separately in *top_hi_out so that no lane needs to be wider than _cc_addr_t. *valid_out is set to 1 if the
+ * bounds are valid and 0 otherwise.
+ * All temporaries are _cc_addr_t (rather than a mix of bool/int/unsigned) so that every lane has the same width.
+ */
+static inline __attribute__((always_inline)) void
+_cc_N(compute_base_top_lane__)(_cc_addr_t pesbt, _cc_addr_t cursor, _cc_addr_t* base_out, _cc_addr_t* top_lo_out,
+                               uint8_t* top_hi_out, uint8_t* exp_out, uint8_t* valid_out) {
+#define _cc_select(cond, a, b) _cc_N(lane_select__)((_cc_addr_t)(cond), (a), (b))
+    const _cc_addr_t W = _CC_ADDR_WIDTH;
+    const _cc_addr_t MW = _CC_MANTISSA_WIDTH;
+    const _cc_addr_t BMask = ((_cc_addr_t)1 << MW) - 1;
+    const _cc_addr_t exp_bits = (_cc_addr_t)(_CC_EXTRACT_FIELD(pesbt, EXPONENT_LOW_PART) |
+                                             (_CC_EXTRACT_FIELD(pesbt, EXPONENT_HIGH_PART)
+                                              << _CC_N(FIELD_EXPONENT_LOW_PART_SIZE)));
+    _cc_addr_t zero_exp_pesbt = pesbt;
+#if _CC_N(FIELD_EF_USED) == 1
+    _cc_addr_t internal = (_cc_addr_t)_CC_EXTRACT_FIELD(pesbt, EF) ^ 1;
+    _cc_addr_t e_enc = exp_bits | (_cc_addr_t)(_CC_EXTRACT_FIELD(pesbt, L8) << (_CC_N(FIELD_EXPONENT_LOW_PART_SIZE) +
+                                                                               _CC_N(FIELD_EXPONENT_HIGH_PART_SIZE)));
+    _cc_addr_t malformed = internal & (_cc_addr_t)(e_enc > _CC_MAX_EXPONENT);
+    // Unlike bounds.E this can never become negative since malformed exponents are replaced by zero.
+    _cc_addr_t E = _cc_select(internal & (malformed ^ 1), _CC_MAX_EXPONENT - e_enc, 0);
+#else
+    _cc_addr_t internal = (_cc_addr_t)_CC_EXTRACT_FIELD(pesbt, INTERNAL_EXPONENT);
+    _cc_addr_t E = _cc_select(internal, exp_bits, 0);
+#ifdef CC_IS_MORELLO
+    zero_exp_pesbt ^= _CC_N(NULL_XOR_MASK);
+#endif
+#endif
+    _cc_addr_t L_msb = _cc_select(internal, 1, (_cc_addr_t)_CC_EXTRACT_FIELD(zero_exp_pesbt, L8));
+    _cc_addr_t B = _cc_select(
+        internal, (_cc_addr_t)_CC_EXTRACT_FIELD(pesbt, EXP_NONZERO_BOTTOM) << _CC_N(FIELD_EXPONENT_LOW_PART_SIZE),
+        (_cc_addr_t)_CC_EXTRACT_FIELD(zero_exp_pesbt, EXP_ZERO_BOTTOM));
+    _cc_addr_t T = _cc_select(
+        internal, (_cc_addr_t)_CC_EXTRACT_FIELD(pesbt, EXP_NONZERO_TOP) << _CC_N(FIELD_EXPONENT_HIGH_PART_SIZE),
+        (_cc_addr_t)_CC_EXTRACT_FIELD(zero_exp_pesbt, EXP_ZERO_TOP));
+    _cc_addr_t L_carry = (_cc_addr_t)(T < (B & (BMask >> 2)));
+    T |= (((B >> (MW - 2)) + L_carry + L_msb) & 0x3) << (MW - 2);
+#if _CC_N(FIELD_EF_USED) == 1
+    B = _cc_select(malformed, 0, B);
+    T = _cc_select(malformed, 0, T);
+    // Same checks as bounds_bits_valid()
+    _cc_addr_t invalid = ((_cc_addr_t)_CC_N(FIELD_L8_USED) & (_cc_addr_t)(E == 0)) |
+                         ((_cc_addr_t)(E == _CC_MAX_EXPONENT - 1) & (B >> (MW - 1))) |
+                         ((_cc_addr_t)(E == _CC_MAX_EXPONENT) & (_cc_addr_t)(B != 0));
+    _cc_addr_t valid = (internal & invalid) ^ 1;
+#else
+    _cc_addr_t valid = 1;
+#endif
+
+    cursor = _cc_N(cap_bounds_address)(cursor);
+    _cc_addr_t Ec = _cc_select(E > _CC_MAX_EXPONENT, _CC_MAX_EXPONENT, E);
+#if _CC_N(FIELD_EF_USED) == 1
+    _cc_addr_t R = (B - ((_cc_addr_t)1 << (MW - 2))) & BMask;
+    _cc_addr_t aHi = (_cc_addr_t)(((cursor >> Ec) & BMask) < R);
+    _cc_addr_t bHi = (_cc_addr_t)(B < R);
+    _cc_addr_t tHi = (_cc_addr_t)(T < R);
+#else
+    _cc_addr_t R3 = ((B >> (MW - 3)) - 1) & 0x7;
+    _cc_addr_t aHi = (_cc_addr_t)(((cursor >> (Ec + MW - 3)) & 0x7) < R3);
+    _cc_addr_t bHi = (_cc_addr_t)((B >> (MW - 3)) < R3);
+    _cc_addr_t tHi = (_cc_addr_t)((T >> (MW - 3)) < R3);
+#endif
+    // Shift amounts are masked to W - 1 so that the unselected operand of each select is well-defined.
+    _cc_addr_t shift = Ec + MW;
+    _cc_addr_t a_top = _cc_select(shift < W, cursor >> (shift & (W - 1)), 0);
+    _cc_addr_t base_region = a_top + bHi - aHi;
+    _cc_addr_t top_region = a_top + tHi - aHi;
+    _cc_addr_t base = _cc_select(shift < W, base_region << (shift & (W - 1)), 0) | (B << Ec);
+    _cc_addr_t top = _cc_select(shift < W, top_region << (shift & (W - 1)), 0) | (T << Ec);
+    // Bit W of top comes from the region bits if E + MW <= W and from T otherwise.
+    _cc_addr_t top_hi =
+        _cc_select(shift <= W, top_region >> ((W - shift) & (W - 1)), T >> ((W - Ec) & (W - 1))) & 1;
+    _cc_addr_t base2 = (base >> (W - 1)) & 1;
+    _cc_addr_t top2 = (top_hi << 1) | ((top >> (W - 1)) & 1);
+    top_hi ^= (_cc_addr_t)(Ec < _CC_MAX_EXPONENT - 1) & (_cc_addr_t)((top2 - base2) > 1);
+#ifdef CC_IS_MORELLO
+    _cc_addr_t large_exp = (_cc_addr_t)(E > _CC_MAX_EXPONENT);
+    valid = _cc_select(large_exp, (_cc_addr_t)(E == _CC_N(MAX_ENCODABLE_EXPONENT)), valid);
+    base = _cc_select(large_exp, 0, base);
+    top = _cc_select(large_exp, 0, top);
+    top_hi = _cc_select(large_exp, 1, top_hi);
+#elif _CC_N(FIELD_EF_USED) == 1
+    base = _cc_select(valid, base, 0);
+    top = _cc_select(valid, top, 0);
+    top_hi = _cc_select(valid, top_hi, 0);
+#endif
+    *base_out = base;
+    *top_lo_out = top;
+    *top_hi_out = (uint8_t)top_hi;
+    *exp_out = (uint8_t)E;
+    *valid_out = (uint8_t)valid;
+#undef _cc_select
+}
+
+/*
+ * Decode the bounds of count capabilities in raw (in-register) format, equivalent to calling extract_bounds_bits() and
+ * compute_base_top() on each element. Top is split into its low _CC_ADDR_WIDTH bits (tops_lo) and the carry bit
+ * (tops_hi). Exponents are stored as in cr_exp and valid[i] is 1 if the bounds are valid and 0 otherwise. The output arrays must not overlap each other or the inputs.
+ */
+static _CC_BATCH_KERNEL void _cc_N(compute_base_top_batch)(const _cc_addr_t* _CC_RESTRICT pesbts,
+                                                           const _cc_addr_t* _CC_RESTRICT cursors, size_t count,
+                                                           _cc_addr_t* _CC_RESTRICT bases,
+                                                           _cc_addr_t* _CC_RESTRICT tops_lo,
+                                                           uint8_t* _CC_RESTRICT tops_hi, uint8_t* _CC_RESTRICT exps,
+                                                           uint8_t* _CC_RESTRICT valid) {
+    for (size_t i = 0; i < count; i++) {
+        _cc_N(compute_base_top_lane__)(pesbts[i], cursors[i], &bases[i], &tops_lo[i], &tops_hi[i], &exps[i], &valid[i]);
+    }
+}
+
 #define CAP_AP_C   (1 << 0)
 #define CAP_AP_W   (1 << 1)
 #define CAP_AP_R   (1 << 2)
@@ -846,32 +1025,64 @@ static inline void _cc_N(m_ap_decompress)(_cc_cap_t *cap)
 }
 #endif
 
-/// Expand a PESBT+address+tag input to a _cc_cap_t, but don't check that the tagged value is derivable.
+/*
+ * Decode only the bounds of a capability given the raw (already XOR'ed) pesbt
+ * and cursor. This is the same computation as _cc_N(decompress_raw) but does
+ * not fill in a _cc_cap_t, decode permissions or check tag invariants, so it is
+ * suitable for bounds checks on hot paths. If @p exp_out is not NULL, it is set
+ * to the value that would be stored in cr_exp. Returns the bounds validity.
+ */
+static inline bool _cc_N(decode_bounds)(_cc_addr_t pesbt, _cc_addr_t cursor, _cc_addr_t* base_out,
+                                        _cc_length_t* top_out, uint8_t* exp_out) {
+    _cc_bounds_bits bounds = _cc_N(extract_bounds_bits)(pesbt);
+    if (exp_out) {
+        *exp_out = bounds.E;
+    }
+    return _cc_N(compute_base_top)(bounds, cursor, base_out, top_out);
+}
+
+/// Like _cc_N(decode_bounds), but takes the pesbt value in the in-memory format.
+static inline bool _cc_N(decode_bounds_mem)(_cc_addr_t pesbt, _cc_addr_t cursor, _cc_addr_t* base_out,
+                                            _cc_length_t* top_out, uint8_t* exp_out) {
+    return _cc_N(decode_bounds)(pesbt ^ _CC_N(NULL_XOR_MASK), cursor, base_out, top_out, exp_out);
+}
+
+/// Fill in all fields of @p cdp that are derived from PESBT+address+tag. Unlike unsafe_decompress_raw this does not
+/// clear @p cdp first, so cr_extra and any padding bytes must already have been zeroed by the caller.
 /// This is an internal helper and should not not be used outside of this header.
-static inline void _cc_N(unsafe_decompress_raw)(_cc_addr_t pesbt, _cc_addr_t cursor, bool tag, uint8_t lvbits, _cc_cap_t* cdp) {
-    memset(cdp, 0, sizeof(*cdp));
+static inline void _cc_N(decompress_fields__)(_cc_addr_t pesbt, _cc_addr_t cursor, bool tag, uint8_t lvbits,
+                                              _cc_cap_t* cdp) {
     cdp->cr_tag = tag;
     cdp->_cr_cursor = cursor;
     cdp->cr_pesbt = pesbt;
     cdp->cr_lvbits = lvbits;
 
-    _cc_bounds_bits bounds = _cc_N(extract_bounds_bits)(pesbt);
-    bool valid = _cc_N(compute_base_top)(bounds, cursor, &cdp->cr_base, &cdp->_cr_top);
-    cdp->cr_bounds_valid = valid;
-    cdp->cr_exp = bounds.E;
+    cdp->cr_bounds_valid = _cc_N(decode_bounds)(pesbt, cursor, &cdp->cr_base, &cdp->_cr_top, &cdp->cr_exp);
     _cc_N(m_ap_decompress)(cdp);
 }
 
+/// Expand a PESBT+address+tag input to a _cc_cap_t, but don't check that the tagged value is derivable.
+/// This is an internal helper and should not not be used outside of this header.
+static inline void _cc_N(unsafe_decompress_raw)(_cc_addr_t pesbt, _cc_addr_t cursor, bool tag, uint8_t lvbits, _cc_cap_t* cdp) {
+    memset(cdp, 0, sizeof(*cdp));
+    _cc_N(decompress_fields__)(pesbt, cursor, tag, lvbits, cdp);
+}
+
+/// Sanity checks for a capability that was decompressed with the tag bit set.
+static inline void _cc_N(check_tagged_decompress__)(__attribute__((unused)) const _cc_cap_t* cdp) {
+    _cc_debug_assert(cdp->cr_base <= _CC_N(MAX_ADDR));
+#ifndef CC_IS_MORELLO
+    // Morello is perfectly happy using settag to create capabilities with length greater than 2^64.
+    _cc_debug_assert(cdp->_cr_top <= _CC_N(MAX_TOP));
+    _cc_debug_assert(cdp->cr_base <= cdp->_cr_top);
+#endif
+    _cc_debug_assert(_CC_EXTRACT_FIELD(cdp->cr_pesbt, RESERVED) == 0);
+}
+
 static inline void _cc_N(decompress_raw__)(_cc_addr_t pesbt, _cc_addr_t cursor, bool tag, uint8_t lvbits,_cc_cap_t* cdp) {
     _cc_N(unsafe_decompress_raw)(pesbt, cursor, tag, lvbits, cdp);
     if (tag) {
-        _cc_debug_assert(cdp->cr_base <= _CC_N(MAX_ADDR));
-#ifndef CC_IS_MORELLO
-        // Morello is perfectly happy using settag to create capabilities with length greater than 2^64.
-        _cc_debug_assert(cdp->_cr_top <= _CC_N(MAX_TOP));
-        _cc_debug_assert(cdp->cr_base <= cdp->_cr_top);
-#endif
-        _cc_debug_assert(_CC_EXTRACT_FIELD(pesbt, RESERVED) == 0);
+        _cc_N(check_tagged_decompress__)(cdp);
     }
 }
 
@@ -886,6 +1097,123 @@ static inline void _cc_N(decompress_mem)(uint64_t pesbt, uint64_t cursor, bool t
     _cc_N(decompress_raw__)(pesbt ^ _CC_N(NULL_XOR_MASK), cursor, tag, 0, cdp);
 }
 
+/// Returns the tag for capability @p index from a packed tag bitmap (bit (index % 64) of word index / 64).
+static inline bool _cc_N(tag_bitmap_get)(const uint64_t* tags, size_t index) {
+    return (tags[index / 64] >> (index % 64)) & 1;
+}
+
+/// Sets the tag for capability @p index in a packed tag bitmap (see _cc_N(tag_bitmap_get)).
+static inline void _cc_N(tag_bitmap_set)(uint64_t* tags, size_t index, bool value) {
+    tags[index / 64] = (tags[index / 64] & ~(UINT64_C(1) << (index % 64))) | ((uint64_t)value << (index % 64));
+}
+
+static inline void _cc_N(decompress_batch__)(const _cc_addr_t* pesbts, const _cc_addr_t* cursors, const uint64_t* tags,
+                                             size_t count, _cc_addr_t xor_mask, _cc_cap_t* out) {
+    // Clear the whole output range once instead of zeroing every capability individually.
+    memset(out, 0, count * sizeof(*out));
+    for (size_t i = 0; i < count; i++) {
+        bool tag = tags != NULL && _cc_N(tag_bitmap_get)(tags, i);
+        _cc_N(decompress_fields__)(pesbts[i] ^ xor_mask, cursors[i], tag, 0, &out[i]);
+        if (tag) {
+            _cc_N(check_tagged_decompress__)(&out[i]);
+        }
+    }
+}
+
+/*
+ * Decompress @p count capabilities from parallel arrays of raw (already
+ * XOR'ed) pesbt and cursor values. The tag for capability i is bit (i % 64) of
+ * tags[i / 64]; if @p tags is NULL all capabilities are decoded as untagged.
+ * The result is identical to calling _cc_N(decompress_raw) for every element.
+ */
+static inline void _cc_N(decompress_raw_batch)(const _cc_addr_t* pesbts, const _cc_addr_t* cursors,
+                                               const uint64_t* tags, size_t count, _cc_cap_t* out) {
+    _cc_N(decompress_batch__)(pesbts, cursors, tags, count, 0, out);
+}
+
+/*
+ * Like _cc_N(decompress_raw_batch), but takes the pesbt values in the
+ * in-memory format (i.e. as passed to _cc_N(decompress_mem)).
+ */
+static inline void _cc_N(decompress_mem_batch)(const _cc_addr_t* pesbts, const _cc_addr_t* cursors,
+                                               const uint64_t* tags, size_t count, _cc_cap_t* out) {
+    _cc_N(decompress_batch__)(pesbts, cursors, tags, count, _CC_N(NULL_XOR_MASK), out);
+}
+
+/*
+ * Iterator over the tagged capabilities of a memory image (e.g. a mmap()ed
+ * emulator snapshot). The image holds one capability per granule in the
+ * in-memory layout: the cursor word followed by the pesbt word, both in host
+ * byte order. @p tags has one bit per granule as for _cc_N(tag_bitmap_get).
+ * Whole words of the tag bitmap are skipped at a time, and untagged granules
+ * of the image are never read.
+ */
+struct _cc_N(tag_scanner) {
+    const unsigned char* image;
+    const uint64_t* tags;
+    size_t granules;
+    size_t next;
+};
+typedef struct _cc_N(tag_scanner) _cc_N(tag_scanner_t);
+#define _cc_tag_scanner_t _cc_N(tag_scanner_t)
+
+static inline void _cc_N(tag_scanner_init)(_cc_tag_scanner_t* scanner, const void* image, const uint64_t* tags,
+                                           size_t granules) {
+    scanner->image = (const unsigned char*)image;
+    scanner->tags = tags;
+    scanner->granules = granules;
+    scanner->next = 0;
+}
+
+/// Decompresses the next tagged capability into @p out and stores its granule index in @p granule.
+/// Returns false once there are no more tagged granules.
+static inline bool _cc_N(tag_scanner_next)(_cc_tag_scanner_t* scanner, size_t* granule, _cc_cap_t* out) {
+    size_t index = scanner->next;
+    while (index < scanner->granules) {
+        uint64_t word = scanner->tags[index / 64] & (UINT64_MAX << (index % 64));
+        if (word == 0) {
+            index = (index / 64 + 1) * 64;
+            continue;
+        }
+        index = (index & ~(size_t)63) + (size_t)__builtin_ctzll(word);
+        if (index >= scanner->granules)
+            break;
+        const unsigned char* granule_addr = scanner->image + index * 2 * sizeof(_cc_addr_t);
+        _cc_addr_t cursor, pesbt;
+        memcpy(&cursor, granule_addr, sizeof(cursor));
+        memcpy(&pesbt, granule_addr + sizeof(cursor), sizeof(pesbt));
+        _cc_N(decompress_mem)(pesbt, cursor, true, out);
+        *granule = index;
+        scanner->next = index + 1;
+        return true;
+    }
+    scanner->next = scanner->granules;
+    return false;
+}
+
+/// Callback for _cc_N(scan_tagged_mem). Returning false stops the scan.
+typedef bool (*_cc_N(scan_callback_t))(void* ctx, size_t granule, const _cc_cap_t* cap);
+
+/*
+ * Calls @p callback for every tagged capability in @p image (see
+ * _cc_N(tag_scanner)) in increasing granule order.
+ * @return the number of capabilities passed to @p callback.
+ */
+static inline size_t _cc_N(scan_tagged_mem)(const void* image, const uint64_t* tags, size_t granules,
+                                            _cc_N(scan_callback_t) callback, void* ctx) {
+    _cc_tag_scanner_t scanner;
+    _cc_N(tag_scanner_init)(&scanner, image, tags, granules);
+    size_t visited = 0;
+    size_t granule;
+    _cc_cap_t cap;
+    while (_cc_N(tag_scanner_next)(&scanner, &granule, &cap)) {
+        visited++;
+        if (!callback(ctx, granule, &cap))
+            break;
+    }
+    return visited;
+}
+
 static inline bool _cc_N(is_cap_sealed)(const _cc_cap_t* cp) {
 #if _CC_N(FIELD_OTYPE_USED) == 1
     return _cc_N(get_otype)(cp) != _CC_N(OTYPE_UNSEALED);
@@ -928,6 +1256,247 @@ static inline _cc_addr_t _cc_N(compress_mem)(const _cc_cap_t* csp) {
     return _cc_N(compress_raw)(csp) ^ _CC_N(NULL_XOR_MASK);
 }
 
+/*
+ * Structure-of-arrays table of decoded capabilities. Unlike an array of
+ * _cc_cap_t, queries that only need some of the fields (e.g. bounds) only touch
+ * the corresponding columns. Bit _CC_ADDR_WIDTH of top and the tags are stored
+ * as bitmaps in the same layout as used by _cc_N(tag_bitmap_get).
+ */
+struct _cc_N(cap_table) {
+    size_t count;
+    _cc_addr_t* base;
+    _cc_addr_t* top_lo;   // Low _CC_ADDR_WIDTH bits of top
+    uint64_t* top_hi;     // Bit _CC_ADDR_WIDTH of top
+    _cc_addr_t* cursor;
+    _cc_addr_t* pesbt;    // Raw (already XOR'ed) pesbt
+    uint8_t* exponent;    // Same value as cr_exp
+    uint64_t* tags;
+};
+typedef struct _cc_N(cap_table) _cc_N(cap_table_t);
+#define _cc_cap_table_t _cc_N(cap_table_t)
+
+static inline void _cc_N(cap_table_free)(_cc_cap_table_t* table) {
+    free(table->base);
+    free(table->top_lo);
+    free(table->top_hi);
+    free(table->cursor);
+    free(table->pesbt);
+    free(table->exponent);
+    free(table->tags);
+    memset(table, 0, sizeof(*table));
+}
+
+/// Allocate a zero-initialized table for @p count capabilities. Returns false if memory allocation failed.
+static inline bool _cc_N(cap_table_init)(_cc_cap_table_t* table, size_t count) {
+    // Allocate at least one element so that NULL always indicates failure.
+    size_t alloc_count = count ? count : 1;
+    size_t bitmap_words = (alloc_count + 63) / 64;
+    table->count = count;
+    table->base = (_cc_addr_t*)calloc(alloc_count, sizeof(_cc_addr_t));
+    table->top_lo = (_cc_addr_t*)calloc(alloc_count, sizeof(_cc_addr_t));
+    table->top_hi = (uint64_t*)calloc(bitmap_words, sizeof(uint64_t));
+    table->cursor = (_cc_addr_t*)calloc(alloc_count, sizeof(_cc_addr_t));
+    table->pesbt = (_cc_addr_t*)calloc(alloc_count, sizeof(_cc_addr_t));
+    table->exponent = (uint8_t*)calloc(alloc_count, sizeof(uint8_t));
+    table->tags = (uint64_t*)calloc(bitmap_words, sizeof(uint64_t));
+    if (!table->base || !table->top_lo || !table->top_hi || !table->cursor || !table->pesbt || !table->exponent ||
+        !table->tags) {
+        _cc_N(cap_table_free)(table);
+        return false;
+    }
+    return true;
+}
+
+static inline _cc_length_t _cc_N(cap_table_top)(const _cc_cap_table_t* table, size_t index) {
+    return (_cc_length_t)table->top_lo[index] |
+           ((_cc_length_t)_cc_N(tag_bitmap_get)(table->top_hi, index) << _CC_ADDR_WIDTH);
+}
+
+static inline bool _cc_N(cap_table_tag)(const _cc_cap_table_t* table, size_t index) {
+    return _cc_N(tag_bitmap_get)(table->tags, index);
+}
+
+static inline void _cc_N(cap_table_decode__)(_cc_cap_table_t* table, size_t start, const _cc_addr_t* pesbts,
+                                             const _cc_addr_t* cursors, const uint64_t* tags, size_t count,
+                                             _cc_addr_t xor_mask) {
+    _cc_api_requirement(start <= table->count && count <= table->count - start, "range out of bounds");
+    for (size_t i = 0; i < count; i++) {
+        table->pesbt[start + i] = pesbts[i] ^ xor_mask;
+        table->cursor[start + i] = cursors[i];
+        _cc_N(tag_bitmap_set)(table->tags, start + i, tags != NULL && _cc_N(tag_bitmap_get)(tags, i));
+    }
+    // Decode in chunks so that the byte-per-capability outputs of the batch kernel fit on the stack.
+    for (size_t chunk = 0; chunk < count; chunk += 64) {
+        size_t first = start + chunk;
+        size_t n = _CC_MIN(count - chunk, (size_t)64);
+        uint8_t top_hi[64];
+        uint8_t valid[64];
+        _cc_N(compute_base_top_batch)(&table->pesbt[first], &table->cursor[first], n, &table->base[first],
+                                      &table->top_lo[first], top_hi, &table->exponent[first], valid);
+        for (size_t i = 0; i < n; i++) {
+            _cc_N(tag_bitmap_set)(table->top_hi, first + i, top_hi[i]);
+        }
+    }
+}
+
+/*
+ * Decode @p count capabilities from parallel arrays of raw (already XOR'ed)
+ * pesbt and cursor values into rows [start, start + count) of @p table. Tags
+ * use the same bitmap layout (and NULL convention) as _cc_N(decompress_raw_batch).
+ */
+static inline void _cc_N(cap_table_decode_raw)(_cc_cap_table_t* table, size_t start, const _cc_addr_t* pesbts,
+                                               const _cc_addr_t* cursors, const uint64_t* tags, size_t count) {
+    _cc_N(cap_table_decode__)(table, start, pesbts, cursors, tags, count, 0);
+}
+
+/// Like _cc_N(cap_table_decode_raw), but takes the pesbt values in the in-memory format.
+static inline void _cc_N(cap_table_decode_mem)(_cc_cap_table_t* table, size_t start, const _cc_addr_t* pesbts,
+                                               const _cc_addr_t* cursors, const uint64_t* tags, size_t count) {
+    _cc_N(cap_table_decode__)(table, start, pesbts, cursors, tags, count, _CC_N(NULL_XOR_MASK));
+}
+
+static inline void _cc_N(cap_table_encode__)(const _cc_cap_table_t* table, size_t start, size_t count,
+                                             _cc_addr_t* pesbts, _cc_addr_t* cursors, uint64_t* tags,
+                                             _cc_addr_t xor_mask) {
+    _cc_api_requirement(start <= table->count && count <= table->count - start, "range out of bounds");
+    for (size_t i = 0; i < count; i++) {
+        pesbts[i] = table->pesbt[start + i] ^ xor_mask;
+        cursors[i] = table->cursor[start + i];
+        if (tags != NULL) {
+            _cc_N(tag_bitmap_set)(tags, i, _cc_N(tag_bitmap_get)(table->tags, start + i));
+        }
+    }
+}
+
+/*
+ * Encode rows [start, start + count) of @p table into parallel arrays of raw
+ * pesbt and cursor values. If @p tags is not NULL, bit i of the tag bitmap is
+ * set to the tag of row start + i.
+ */
+static inline void _cc_N(cap_table_encode_raw)(const _cc_cap_table_t* table, size_t start, size_t count,
+                                               _cc_addr_t* pesbts, _cc_addr_t* cursors, uint64_t* tags) {
+    _cc_N(cap_table_encode__)(table, start, count, pesbts, cursors, tags, 0);
+}
+
+/// Like _cc_N(cap_table_encode_raw), but returns the pesbt values in the in-memory format.
+static inline void _cc_N(cap_table_encode_mem)(const _cc_cap_table_t* table, size_t start, size_t count,
+                                               _cc_addr_t* pesbts, _cc_addr_t* cursors, uint64_t* tags) {
+    _cc_N(cap_table_encode__)(table, start, count, pesbts, cursors, tags, _CC_N(NULL_XOR_MASK));
+}
+
+/// Store a single (already compressed) capability in row @p index of @p table.
+static inline void _cc_N(cap_table_set)(_cc_cap_table_t* table, size_t index, const _cc_cap_t* cap) {
+    _cc_api_requirement(index < table->count, "index out of bounds");
+    table->pesbt[index] = _cc_N(compress_raw)(cap);
+    table->cursor[index] = cap->_cr_cursor;
+    table->base[index] = cap->cr_base;
+    table->top_lo[index] = (_cc_addr_t)cap->_cr_top;
+    table->exponent[index] = cap->cr_exp;
+    _cc_N(tag_bitmap_set)(table->top_hi, index, (bool)(cap->_cr_top >> _CC_ADDR_WIDTH));
+    _cc_N(tag_bitmap_set)(table->tags, index, cap->cr_tag);
+}
+
+/// Fully decompress row @p index of @p table, equivalent to _cc_N(decompress_raw) on the stored values.
+static inline void _cc_N(cap_table_get)(const _cc_cap_table_t* table, size_t index, _cc_cap_t* out) {
+    _cc_api_requirement(index < table->count, "index out of bounds");
+    _cc_N(decompress_raw)(table->pesbt[index], table->cursor[index], _cc_N(cap_table_tag)(table, index), out);
+}
+
+/*
+ * A capability handle that only decodes the bounds and permissions the first time they are requested. Copying and
+ * comparing only needs pesbt, cursor and tag; the remaining members memoize the decoded values. Top is stored as two
+ * _cc_addr_t-sized halves so that the structure does not need the 16-byte alignment of _cc_length_t.
+ * The members other than pesbt, cursor and tag should only be accessed through the _cc_N(lazy_cap_*) functions.
+ */
+enum {
+    _CC_N(LAZY_CAP_BOUNDS_DECODED) = 1 << 0,
+    _CC_N(LAZY_CAP_PERMS_DECODED) = 1 << 1,
+};
+
+struct _cc_N(lazy_cap) {
+    _cc_addr_t pesbt; // Raw (already XOR'ed) pesbt
+    _cc_addr_t cursor;
+    uint8_t tag;
+    uint8_t decoded; // Bitmask of _CC_N(LAZY_CAP_*_DECODED)
+    uint8_t bounds_valid;
+    uint8_t top_hi;
+    uint16_t arch_perm;
+    uint8_t m;
+    uint8_t exp;
+    _cc_addr_t base;
+    _cc_addr_t top_lo;
+};
+typedef struct _cc_N(lazy_cap) _cc_N(lazy_cap_t);
+#define _cc_lazy_cap_t _cc_N(lazy_cap_t)
+
+static inline void _cc_N(lazy_cap_init_raw)(_cc_lazy_cap_t* lc, _cc_addr_t pesbt, _cc_addr_t cursor, bool tag) {
+    memset(lc, 0, sizeof(*lc));
+    lc->pesbt = pesbt;
+    lc->cursor = cursor;
+    lc->tag = tag;
+}
+
+static inline void _cc_N(lazy_cap_init_mem)(_cc_lazy_cap_t* lc, _cc_addr_t pesbt, _cc_addr_t cursor, bool tag) {
+    _cc_N(lazy_cap_init_raw)(lc, pesbt ^ _CC_N(NULL_XOR_MASK), cursor, tag);
+}
+
+static inline bool _cc_N(lazy_cap_exactly_equal)(const _cc_lazy_cap_t* a, const _cc_lazy_cap_t* b) {
+    return a->tag == b->tag && a->cursor == b->cursor && a->pesbt == b->pesbt;
+}
+
+static inline void _cc_N(lazy_cap_decode_bounds__)(_cc_lazy_cap_t* lc) {
+    if (lc->decoded & _CC_N(LAZY_CAP_BOUNDS_DECODED))
+        return;
+    _cc_length_t top;
+    lc->bounds_valid = _cc_N(decode_bounds)(lc->pesbt, lc->cursor, &lc->base, &top, &lc->exp);
+    lc->top_lo = (_cc_addr_t)top;
+    lc->top_hi = (uint8_t)(top >> _CC_ADDR_WIDTH);
+    lc->decoded |= _CC_N(LAZY_CAP_BOUNDS_DECODED);
+}
+
+static inline _cc_addr_t _cc_N(lazy_cap_base)(_cc_lazy_cap_t* lc) {
+    _cc_N(lazy_cap_decode_bounds__)(lc);
+    return lc->base;
+}
+
+static inline _cc_length_t _cc_N(lazy_cap_top)(_cc_lazy_cap_t* lc) {
+    _cc_N(lazy_cap_decode_bounds__)(lc);
+    return (_cc_length_t)lc->top_lo | ((_cc_length_t)lc->top_hi << _CC_ADDR_WIDTH);
+}
+
+static inline bool _cc_N(lazy_cap_bounds_valid)(_cc_lazy_cap_t* lc) {
+    _cc_N(lazy_cap_decode_bounds__)(lc);
+    return lc->bounds_valid;
+}
+
+static inline uint8_t _cc_N(lazy_cap_exp)(_cc_lazy_cap_t* lc) {
+    _cc_N(lazy_cap_decode_bounds__)(lc);
+    return lc->exp;
+}
+
+/// Returns the same value as the permissions() member of the decompressed capability.
+static inline uint32_t _cc_N(lazy_cap_permissions)(_cc_lazy_cap_t* lc) {
+#if _CC_N(FIELD_HWPERMS_USED)
+    return _cc_N(cap_pesbt_extract_perms)(lc->pesbt);
+#else
+    if (!(lc->decoded & _CC_N(LAZY_CAP_PERMS_DECODED))) {
+        _cc_cap_t tmp;
+        memset(&tmp, 0, sizeof(tmp));
+        tmp.cr_pesbt = lc->pesbt;
+        _cc_N(m_ap_decompress)(&tmp);
+        lc->arch_perm = tmp.cr_arch_perm;
+        lc->m = tmp.cr_m;
+        lc->decoded |= _CC_N(LAZY_CAP_PERMS_DECODED);
+    }
+    return lc->arch_perm;
+#endif
+}
+
+/// Fully decompress @p lc, equivalent to _cc_N(decompress_raw) on the stored values.
+static inline void _cc_N(lazy_cap_decompress)(const _cc_lazy_cap_t* lc, _cc_cap_t* out) {
+    _cc_N(decompress_raw)(lc->pesbt, lc->cursor, lc->tag, out);
+}
+
 static bool _cc_N(fast_is_representable_new_addr)(const _cc_cap_t* cap, _cc_addr_t new_addr);
 
 /// Check that a capability is representable by compressing and recompressing
@@ -963,7 +1532,14 @@ static inline uint32_t _cc_N(compute_ebt)(_cc_addr_t req_base, _cc_length_t req_
      * memory addresses to be wider than requested so it is
      * representable.
      */
+#ifdef _CC_SPLIT_LENGTH_ARITHMETIC
+    const struct _cc_N(length_parts) req_top_parts = _cc_N(length_split__)(req_top);
+    // The length fits in _CC_LEN_WIDTH bits, so its upper part is the top bit of req_top minus the borrow.
+    const _cc_addr_t req_length_hi = req_top_parts.hi - (req_top_parts.lo < req_base ? 1 : 0);
+    const _cc_addr_t req_length_lo = req_top_parts.lo - req_base;
+#else
     _cc_length_t req_length65 = req_top - req_base;
+#endif
     // function setCapBounds(cap, base, top) : (Capability, bits(64), bits(65)) -> (bool, Capability) = {
     //  /* {cap with base=base; length=(bits(64)) length; offset=0} */
     //  let base65 = 0b0 @ base;
@@ -972,8 +1548,14 @@ static inline uint32_t _cc_N(compute_ebt)(_cc_addr_t req_base, _cc_length_t req_
     //     second from the top as assumed during decoding. We ignore the bottom
     //     MW - 1 bits because those are handled by the ie = 0 format. */
     //  let e = 52 - CountLeadingZeros(length[64..13]);
+#ifdef _CC_SPLIT_LENGTH_ARITHMETIC
+    uint8_t E = (uint8_t)(req_length_hi ? _CC_LEN_WIDTH - (_CC_MANTISSA_WIDTH - 1)
+                                        : _cc_N(compute_e)(req_length_lo, _CC_MANTISSA_WIDTH));
+    const uint64_t req_length64 = (uint64_t)req_length_lo;
+#else
     uint8_t E = (uint8_t)_cc_N(get_exponent)(req_length65);
     const uint64_t req_length64 = (uint64_t)req_length65;
+#endif
     // Use internal exponent if e is non-zero or if e is zero but
     // but the implied bit of length is not zero (denormal vs. normal case)
     //  let ie = (e != 0) | length[12];
@@ -1040,18 +1622,30 @@ static inline uint32_t _cc_N(compute_ebt)(_cc_addr_t req_base, _cc_length_t req_
     if (alignment_mask) {
         *alignment_mask = UINT64_MAX << (E + _CC_EXP_LOW_WIDTH);
     }
+#ifdef _CC_SPLIT_LENGTH_ARITHMETIC
+    _cc_addr_t top_ie =
+        _cc_N(truncate64)(_cc_N(length_shr__)(req_top_parts, E + _CC_EXP_LOW_WIDTH), _CC_BOT_INTERNAL_EXP_WIDTH);
+#else
     _cc_addr_t top_ie = _cc_N(truncate64)((_cc_addr_t)(req_top >> (E + _CC_EXP_LOW_WIDTH)), _CC_BOT_INTERNAL_EXP_WIDTH);
+#endif
     //    /* Find out whether we have lost significant bits of base and top using a
     //       mask of bits that we will lose (including 3 extra for exp). */
     //    maskLo : bits(65) = zero_extend(replicate_bits(0b1, e + 3));
     //    z65    : bits(65) = zeros();
     //    lostSignificantBase = (base65 & maskLo) != z65;
     //    lostSignificantTop = (top & maskLo) != z65;
+#ifdef _CC_SPLIT_LENGTH_ARITHMETIC
+    // E + _CC_EXP_LOW_WIDTH is always less than the address width, so maskLo never includes the top bit of req_top.
+    const _cc_addr_t maskLo = (((_cc_addr_t)1u) << (E + _CC_EXP_LOW_WIDTH)) - 1;
+    bool lostSignificantBase = (req_base & maskLo) != 0;
+    bool lostSignificantTop = (req_top_parts.lo & maskLo) != 0;
+#else
     // TODO: stop using _cc_length_t and just handle bit65 set specially?
     const _cc_length_t maskLo = (((_cc_length_t)1u) << (E + _CC_EXP_LOW_WIDTH)) - 1;
     const _cc_length_t zero65 = 0;
     bool lostSignificantBase = (req_base & maskLo) != zero65;
     bool lostSignificantTop = (req_top & maskLo) != zero65;
+#endif
     //    if lostSignificantTop then {
     //      /* we must increment T to make sure it is still above top even with lost bits.
     //         It might wrap around but if that makes B<T then decoding will compensate. */
@@ -1087,7 +1681,12 @@ static inline uint32_t _cc_N(compute_ebt)(_cc_addr_t req_base, _cc_length_t req_
             *alignment_mask = UINT64_MAX << (E + _CC_EXP_LOW_WIDTH + 1);
         }
         const bool incT = lostSignificantTop;
+#ifdef _CC_SPLIT_LENGTH_ARITHMETIC
+        top_ie = _cc_N(truncate64)(_cc_N(length_shr__)(req_top_parts, E + _CC_EXP_LOW_WIDTH + 1),
+                                   _CC_BOT_INTERNAL_EXP_WIDTH);
+#else
         top_ie = _cc_N(truncate64)((_cc_addr_t)(req_top >> (E + _CC_EXP_LOW_WIDTH + 1)), _CC_BOT_INTERNAL_EXP_WIDTH);
+#endif
         if (incT) {
             top_ie = _cc_N(truncate64)(top_ie + 1, _CC_BOT_INTERNAL_EXP_WIDTH);
         }
@@ -1142,6 +1741,85 @@ static inline bool _cc_N(cap_bounds_uses_value)(const _cc_cap_t* cap) {
     return _cc_N(cap_bounds_uses_value_for_exp)(cap->cr_exp);
 }
 
+/*
+ * Returns the part of the cursor that compute_base_top() depends on for the given bounds bits: the address bits above
+ * the mantissa (a_top, zero if the bounds do not use the value) shifted left by one, and the aHi region bit in bit 0.
+ * Two cursors with the same key decode to the same base and top.
+ */
+static inline _cc_addr_t _cc_N(bounds_cursor_key__)(_cc_bounds_bits bounds, _cc_addr_t cursor) {
+    cursor = _cc_N(cap_bounds_address)(cursor);
+    uint8_t E = bounds.E > 0 ? _CC_MIN(_CC_MAX_EXPONENT, bounds.E) : 0;
+#if _CC_N(FIELD_EF_USED) == 1
+    uint16_t a_mid = (uint16_t)_cc_N(truncate_addr)(cursor >> E, _CC_MANTISSA_WIDTH);
+    uint16_t R = (uint16_t)((bounds.B - (1U << (_CC_MANTISSA_WIDTH - 2))) % (1U << _CC_MANTISSA_WIDTH));
+    _cc_addr_t aHi = a_mid < R ? 1 : 0;
+#else
+    unsigned a3 = (unsigned)_cc_N(truncate64)(cursor >> (E + _CC_MANTISSA_WIDTH - 3), 3);
+    unsigned R3 = (unsigned)_cc_N(truncate64)(_cc_truncateLSB(_CC_MANTISSA_WIDTH)(bounds.B, 3) - 1, 3);
+    _cc_addr_t aHi = a3 < R3 ? 1 : 0;
+#endif
+    _cc_addr_t a_top = _cc_N(cap_bounds_uses_value_for_exp)(E) ? cursor >> (E + _CC_MANTISSA_WIDTH) : 0;
+    return (a_top << 1) | aHi;
+}
+
+/*
+ * A small direct-mapped cache of decoded bounds, keyed by the EBT bits of pesbt and the bounds-relevant part of the
+ * cursor (see _cc_N(bounds_cursor_key__)). It is intended for emulators that repeatedly decode the same few
+ * capabilities. A cache is not thread-safe; use one per thread. The number of entries can be changed by defining
+ * _CC_BOUNDS_CACHE_ENTRIES (a power of two) before including this header, consistently across all users.
+ */
+#ifndef _CC_BOUNDS_CACHE_ENTRIES
+#define _CC_BOUNDS_CACHE_ENTRIES 64
+#endif
+_CC_STATIC_ASSERT((_CC_BOUNDS_CACHE_ENTRIES & (_CC_BOUNDS_CACHE_ENTRIES - 1)) == 0, "must be a power of two");
+
+struct _cc_N(bounds_cache_entry) {
+    _cc_length_t top;
+    _cc_addr_t ebt;
+    _cc_addr_t cursor_key;
+    _cc_addr_t base;
+    uint8_t exp;
+    bool valid;
+    bool used;
+};
+
+struct _cc_N(bounds_cache) {
+    struct _cc_N(bounds_cache_entry) entries[_CC_BOUNDS_CACHE_ENTRIES];
+    uint64_t hits;
+    uint64_t misses;
+};
+typedef struct _cc_N(bounds_cache) _cc_N(bounds_cache_t);
+#define _cc_bounds_cache_t _cc_N(bounds_cache_t)
+
+/// Invalidate all entries and reset the hit/miss counters.
+static inline void _cc_N(bounds_cache_init)(_cc_bounds_cache_t* cache) { memset(cache, 0, sizeof(*cache)); }
+
+/// Same as _cc_N(decode_bounds), but looks up the result in @p cache first and stores it there on a miss.
+static inline bool _cc_N(decode_bounds_cached)(_cc_bounds_cache_t* cache, _cc_addr_t pesbt, _cc_addr_t cursor,
+                                               _cc_addr_t* base_out, _cc_length_t* top_out, uint8_t* exp_out) {
+    _cc_bounds_bits bounds = _cc_N(extract_bounds_bits)(pesbt);
+    _cc_addr_t ebt = pesbt & (_cc_addr_t)_CC_N(FIELD_EBT_MASK64);
+    _cc_addr_t cursor_key = _cc_N(bounds_cursor_key__)(bounds, cursor);
+    uint64_t hash = ((uint64_t)ebt ^ ((uint64_t)cursor_key * UINT64_C(0x9e3779b97f4a7c15))) * UINT64_C(0xff51afd7ed558ccd);
+    struct _cc_N(bounds_cache_entry)* entry = &cache->entries[(hash >> 32) & (_CC_BOUNDS_CACHE_ENTRIES - 1)];
+    if (entry->used && entry->ebt == ebt && entry->cursor_key == cursor_key) {
+        cache->hits++;
+    } else {
+        cache->misses++;
+        entry->valid = _cc_N(compute_base_top)(bounds, cursor, &entry->base, &entry->top);
+        entry->ebt = ebt;
+        entry->cursor_key = cursor_key;
+        entry->exp = (uint8_t)bounds.E;
+        entry->used = true;
+    }
+    *base_out = entry->base;
+    *top_out = entry->top;
+    if (exp_out) {
+        *exp_out = entry->exp;
+    }
+    return entry->valid;
+}
+
 static inline bool _cc_N(cap_sign_change)(_cc_addr_t addr1, _cc_addr_t addr2) {
 #ifdef CC_IS_MORELLO
     return ((addr1 ^ addr2) & (1ULL << (63 - MORELLO_FLAG_BITS)));
@@ -1352,6 +2030,61 @@ static inline bool _cc_N(setbounds)(_cc_cap_t* cap, _cc_length_t req_len) {
     return exact;
 }
 
+/*
+ * Derives @p count capabilities from @p parent: out[i] is the result of calling
+ * _cc_N(setbounds) with length lens[i] on a copy of @p parent whose address has
+ * been set to bases[i] using _cc_N(set_addr). The sealed and tag checks on
+ * @p parent are only done once, and the bounds are only decoded again if the
+ * requested bounds were not exactly representable. exact_flags[i] is set to the
+ * return value of _cc_N(setbounds) unless @p exact_flags is NULL.
+ */
+static inline void _cc_N(setbounds_batch)(const _cc_cap_t* parent, const _cc_addr_t* bases, const _cc_length_t* lens,
+                                          size_t count, _cc_cap_t* out, uint8_t* exact_flags) {
+    bool parent_tag = parent->cr_tag && !_cc_N(is_cap_sealed)(parent);
+#ifdef CC_IS_MORELLO
+    parent_tag = parent_tag && parent->cr_bounds_valid;
+    const bool from_large = !_cc_N(cap_bounds_uses_value)(parent);
+#endif
+    for (size_t i = 0; i < count; i++) {
+        _cc_cap_t* cap = &out[i];
+        *cap = *parent;
+        cap->_cr_cursor = bases[i];
+        _cc_addr_t req_base = bases[i];
+#ifdef CC_IS_MORELLO
+        if (!from_large) {
+            req_base = _cc_N(cap_bounds_address)(req_base);
+        }
+#endif
+        _cc_length_t req_top = (_cc_length_t)req_base + lens[i];
+        bool tag = parent_tag && req_base >= parent->cr_base && req_top <= parent->_cr_top;
+        bool exact = false;
+        uint32_t new_ebt = _cc_N(compute_ebt)(req_base, req_top, NULL, &exact);
+#ifndef CC_IS_MORELLO
+        // Exact bounds decode to the requested values, so there is no need to run compute_base_top().
+        if (exact) {
+            cap->cr_base = req_base;
+            cap->_cr_top = req_top;
+            cap->cr_bounds_valid = true;
+        } else
+#endif
+        {
+            cap->cr_bounds_valid = _cc_N(compute_base_top)(_cc_N(extract_bounds_bits)(_CC_ENCODE_FIELD(new_ebt, EBT)),
+                                                           cap->_cr_cursor, &cap->cr_base, &cap->_cr_top);
+        }
+#ifdef CC_IS_MORELLO
+        bool to_small = _cc_N(cap_bounds_uses_value_for_exp)(_cc_N(extract_bounds_bits)(new_ebt).E);
+        if ((from_large && to_small) && _cc_N(cap_bounds_address)(cap->_cr_cursor) != cap->_cr_cursor) {
+            tag = false;
+        }
+#endif
+        cap->cr_tag = tag;
+        _cc_N(update_ebt)(cap, new_ebt);
+        if (exact_flags) {
+            exact_flags[i] = exact;
+        }
+    }
+}
+
 /** Like setbounds, but also asserts that the operation is strictly monotonic. */
 static inline bool _cc_N(checked_setbounds)(_cc_cap_t* cap, _cc_length_t req_len) {
     __attribute__((unused)) _cc_addr_t req_base =
@@ -1409,18 +2142,23 @@ static inline _cc_cap_t _cc_N(make_max_perms_cap)(_cc_addr_t base, _cc_addr_t cu
 
 /* @return the mask that needs to be applied to base in order to get a precisely representable capability */
 static inline _cc_addr_t _cc_N(get_alignment_mask)(_cc_addr_t req_length) {
-    if (req_length == 0) {
-        // With a length of zero we know it is precise so we can just return an
-        // all ones mask.
-        // This avoids undefined behaviour when counting most significant bit later.
+    // This is the alignment mask computation of compute_ebt() specialized for a base of zero. With a zero base no
+    // significant bits of the base can be lost, so only the exponent and the top mantissa bits of the length matter.
+    uint32_t E = _cc_N(compute_e)(req_length, _CC_MANTISSA_WIDTH);
+    if (E == 0 && !_cc_N(getbits)(req_length, _CC_BOT_INTERNAL_EXP_WIDTH + 1, 1)) {
+        // Lengths that do not need an internal exponent are always exact.
         return _CC_MAX_ADDR;
     }
-    // To compute the mask we set bounds on a maximum permissions capability and
-    // return the mask that was used to adjust the length
-    _cc_cap_t tmpcap = _cc_N(make_max_perms_cap(0, 0, _CC_MAX_TOP));
-    _cc_addr_t mask = 0;
-    _cc_N(setbounds_impl)(&tmpcap, req_length, &mask);
-    return mask;
+    unsigned shift = E + _CC_EXP_LOW_WIDTH;
+    _cc_addr_t top_ie = _cc_N(truncate64)(req_length >> shift, _CC_BOT_INTERNAL_EXP_WIDTH);
+    if ((req_length & ~(_CC_MAX_ADDR << shift)) != 0) {
+        top_ie = _cc_N(truncate64)(top_ie + 1, _CC_BOT_INTERNAL_EXP_WIDTH);
+    }
+    // If rounding up the length overflowed the mantissa the exponent is incremented by one.
+    if (_cc_N(getbits)(top_ie, _CC_BOT_INTERNAL_EXP_WIDTH - 1, 1)) {
+        shift++;
+    }
+    return (_cc_addr_t)(_CC_MAX_ADDR << shift);
 }
 
 static inline _cc_cap_t _cc_N(make_null_derived_cap)(_cc_addr_t addr) {
@@ -1446,6 +2184,21 @@ static inline _cc_addr_t _cc_N(get_representable_length)(_cc_addr_t req_length)
     return (req_length + ~mask) & mask;
 }
 
+/// Computes _cc_N(get_alignment_mask) for each of the @p count lengths in @p req_lengths.
+static inline void _cc_N(get_alignment_mask_batch)(const _cc_addr_t* req_lengths, size_t count, _cc_addr_t* masks) {
+    for (size_t i = 0; i < count; i++) {
+        masks[i] = _cc_N(get_alignment_mask)(req_lengths[i]);
+    }
+}
+
+/// Computes _cc_N(get_representable_length) for each of the @p count lengths in @p req_lengths.
+static inline void _cc_N(get_representable_length_batch)(const _cc_addr_t* req_lengths, size_t count,
+                                                         _cc_addr_t* lengths) {
+    for (size_t i = 0; i < count; i++) {
+        lengths[i] = _cc_N(get_representable_length)(req_lengths[i]);
+    }
+}
+
 /// Provide a C++ class with the same function names
 /// to simplify writing code that handles both 128 and 64-bit capabilities
 #ifdef __cplusplus
@@ -1458,6 +2211,7 @@ public:
     using addr_t = _cc_addr_t;
     using cap_t = _cc_cap_t;
     using bounds_bits = _cc_bounds_bits;
+    using lazy_cap_t = _cc_lazy_cap_t;
 
     static inline addr_t compress_raw(const cap_t& csp) { return _cc_N(compress_raw)(&csp); }
     static inline cap_t decompress_raw(addr_t pesbt, addr_t cursor, bool tag) {
@@ -1471,8 +2225,32 @@ public:
         _cc_N(decompress_mem)(pesbt, cursor, tag, &result);
         return result;
     }
+    static inline void decompress_mem_batch(const addr_t* pesbts, const addr_t* cursors, const uint64_t* tags,
+                                            size_t count, cap_t* out) {
+        _cc_N(decompress_mem_batch)(pesbts, cursors, tags, count, out);
+    }
+    static inline size_t scan_tagged_mem(const void* image, const uint64_t* tags, size_t granules,
+                                         _cc_N(scan_callback_t) callback, void* ctx) {
+        return _cc_N(scan_tagged_mem)(image, tags, granules, callback, ctx);
+    }
     static inline bounds_bits extract_bounds_bits(addr_t pesbt) { return _cc_N(extract_bounds_bits)(pesbt); }
+    static inline bool decode_bounds(addr_t pesbt, addr_t cursor, addr_t* base, length_t* top) {
+        return _cc_N(decode_bounds)(pesbt, cursor, base, top, NULL);
+    }
+    static inline bool decode_bounds_mem(addr_t pesbt, addr_t cursor, addr_t* base, length_t* top) {
+        return _cc_N(decode_bounds_mem)(pesbt, cursor, base, top, NULL);
+    }
+    static inline void compute_base_top_batch(const addr_t* pesbts, const addr_t* cursors, size_t count,
+                                              addr_t* bases, addr_t* tops_lo, uint8_t* tops_hi, uint8_t* exps,
+                                              uint8_t* valid) {
+        _cc_N(compute_base_top_batch)(pesbts, cursors, count, bases, tops_lo, tops_hi, exps, valid);
+    }
     static inline bool setbounds(cap_t* cap, length_t req_len) { return _cc_N(setbounds)(cap, req_len); }
+    static inline void set_addr(cap_t* cap, addr_t new_addr) { _cc_N(set_addr)(cap, new_addr); }
+    static inline void setbounds_batch(const cap_t& parent, const addr_t* bases, const length_t* lens, size_t count,
+                                       cap_t* out, uint8_t* exact_flags) {
+        _cc_N(setbounds_batch)(&parent, bases, lens, count, out, exact_flags);
+    }
     static inline bool is_representable_cap_exact(const cap_t& cap) { return _cc_N(is_representable_cap_exact)(&cap); }
     static inline cap_t make_max_perms_cap(addr_t base, addr_t cursor, length_t top) {
         return _cc_N(make_max_perms_cap)(base, cursor, top);
@@ -1480,12 +2258,74 @@ public:
     static inline cap_t make_null_derived_cap(addr_t addr) { return _cc_N(make_null_derived_cap)(addr); }
     static inline addr_t representable_length(addr_t len) { return _cc_N(get_representable_length)(len); }
     static inline addr_t representable_mask(addr_t len) { return _cc_N(get_alignment_mask)(len); }
+    static inline void representable_length_batch(const addr_t* lens, size_t count, addr_t* out) {
+        _cc_N(get_representable_length_batch)(lens, count, out);
+    }
+    static inline void representable_mask_batch(const addr_t* lens, size_t count, addr_t* out) {
+        _cc_N(get_alignment_mask_batch)(lens, count, out);
+    }
     static inline bool fast_is_representable_new_addr(const cap_t& cap, addr_t new_addr) {
         return _cc_N(fast_is_representable_new_addr)(&cap, new_addr);
     }
     static inline bool precise_is_representable_new_addr(const cap_t& cap, addr_t new_addr) {
         return _cc_N(precise_is_representable_new_addr)(&cap, new_addr);
     }
+    static inline void lazy_cap_init_raw(lazy_cap_t* lc, addr_t pesbt, addr_t cursor, bool tag) {
+        _cc_N(lazy_cap_init_raw)(lc, pesbt, cursor, tag);
+    }
+    static inline void lazy_cap_init_mem(lazy_cap_t* lc, addr_t pesbt, addr_t cursor, bool tag) {
+        _cc_N(lazy_cap_init_mem)(lc, pesbt, cursor, tag);
+    }
+    static inline bool lazy_cap_exactly_equal(const lazy_cap_t* a, const lazy_cap_t* b) {
+        return _cc_N(lazy_cap_exactly_equal)(a, b);
+    }
+    static inline addr_t lazy_cap_base(lazy_cap_t* lc) { return _cc_N(lazy_cap_base)(lc); }
+    static inline length_t lazy_cap_top(lazy_cap_t* lc) { return _cc_N(lazy_cap_top)(lc); }
+    static inline bool lazy_cap_bounds_valid(lazy_cap_t* lc) { return _cc_N(lazy_cap_bounds_valid)(lc); }
+    static inline uint32_t lazy_cap_permissions(lazy_cap_t* lc) { return _cc_N(lazy_cap_permissions)(lc); }
+    static inline void lazy_cap_decompress(const lazy_cap_t* lc, cap_t* out) { _cc_N(lazy_cap_decompress)(lc, out); }
 };
 #define CompressedCapCC _CC_CONCAT(CompressedCap, CC_FORMAT_LOWER)
+
+#ifndef _CC_LAZY_CAP_DEFINED
+#define _CC_LAZY_CAP_DEFINED
+/// C++ wrapper for the lazily decoded capability handle of a format, e.g. LazyCap<CompressedCap128>.
+template <class Format> class LazyCap {
+public:
+    using addr_t = typename Format::addr_t;
+    using length_t = typename Format::length_t;
+    using cap_t = typename Format::cap_t;
+
+    static inline LazyCap from_raw(addr_t pesbt, addr_t cursor, bool tag) {
+        LazyCap result;
+        Format::lazy_cap_init_raw(&result.state, pesbt, cursor, tag);
+        return result;
+    }
+    static inline LazyCap from_mem(addr_t pesbt, addr_t cursor, bool tag) {
+        LazyCap result;
+        Format::lazy_cap_init_mem(&result.state, pesbt, cursor, tag);
+        return result;
+    }
+    inline bool tag() const { return state.tag; }
+    inline addr_t address() const { return state.cursor; }
+    inline addr_t pesbt() const { return state.pesbt; }
+    inline addr_t base() const { return Format::lazy_cap_base(&state); }
+    inline length_t top() const { return Format::lazy_cap_top(&state); }
+    inline length_t length() const { return top() - base(); }
+    inline bool bounds_valid() const { return Format::lazy_cap_bounds_valid(&state); }
+    inline uint32_t permissions() const { return Format::lazy_cap_permissions(&state); }
+    inline cap_t decompress() const {
+        cap_t result;
+        Format::lazy_cap_decompress(&state, &result);
+        return result;
+    }
+    inline bool operator==(const LazyCap& other) const { return Format::lazy_cap_exactly_equal(&state, &other.state); }
+    inline bool operator!=(const LazyCap& other) const { return !(*this == other); }
+
+private:
+    LazyCap() = default;
+    // The decoded values are a cache, so they may be filled in by const accessors.
+    mutable typename Format::lazy_cap_t state;
+};
+#endif // _CC_LAZY_CAP_DEFINED
 #endif
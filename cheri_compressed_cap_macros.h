@@ -116,4 +116,35 @@ template <size_t a, size_t b> static constexpr bool check_same() {
 #define M_AP_FCTS_IDENT 38
 #define M_AP_FCTS_QUADR 39
 
+/*
+ * Functions marked _CC_CONSTEXPR can be evaluated at compile time from C++14 onwards (e.g. to place pre-built
+ * capabilities in read-only data). They must not use memset() or uninitialized local variables.
+ */
+#if defined(__cplusplus) && __cplusplus >= 201402L
+#define _CC_CONSTEXPR constexpr
+#else
+#define _CC_CONSTEXPR
+#endif
+
+// Array arguments of batch kernels must not overlap, which is required for them to be vectorized.
+#define _CC_RESTRICT __restrict
+
+/*
+ * Batch kernels (functions that operate on arrays of capabilities) are built for several x86 ISA levels and the best
+ * variant is selected at load time by an ifunc resolver. This requires ELF + glibc and GCC 6+ or clang 14+; elsewhere
+ * (or if _CC_NO_TARGET_CLONES is defined) a single generic variant is built and left to the auto-vectorizer.
+ * GCC only uses a cost model that accepts loops with a variable trip count at -O3, so request it explicitly.
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+#define _CC_BATCH_OPTIMIZE optimize("tree-vectorize", "vect-cost-model=dynamic"),
+#else
+#define _CC_BATCH_OPTIMIZE
+#endif
+#if defined(__x86_64__) && defined(__ELF__) && defined(__GLIBC__) && !defined(_CC_NO_TARGET_CLONES) &&               \
+    ((defined(__clang__) && __clang_major__ >= 14) || (!defined(__clang__) && __GNUC__ >= 6))
+#define _CC_BATCH_KERNEL __attribute__((_CC_BATCH_OPTIMIZE target_clones("default", "avx2", "avx512f"), unused))
+#else
+#define _CC_BATCH_KERNEL __attribute__((_CC_BATCH_OPTIMIZE unused))
+#endif
+
 #endif // _CC_CONCAT
@@ -0,0 +1,69 @@
+/*-
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+#include <err.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sysexits.h>
+#include <unistd.h>
+
+#include "cheri_compressed_cap.h"
+
+/*
+ * Lists the tagged capabilities of a memory image. IMAGE contains 16-byte
+ * capability granules (cursor followed by pesbt in host byte order) and TAGS
+ * holds one bit per granule, packed into 64-bit host-endian words.
+ */
+
+static const void* map_file(const char* path, size_t* size) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        err(EX_NOINPUT, "cannot open %s", path);
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+        err(EX_IOERR, "cannot stat %s", path);
+    *size = (size_t)st.st_size;
+    if (*size == 0) {
+        close(fd);
+        return NULL;
+    }
+    void* result = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (result == MAP_FAILED)
+        err(EX_IOERR, "cannot map %s", path);
+    close(fd);
+    return result;
+}
+
+static bool print_cap(void* ctx, size_t granule, const cc128_cap_t* cap) {
+    (void)ctx;
+    cc128_length_t top = cap->_cr_top;
+    printf("0x%016" PRIx64 ": pesbt=0x%016" PRIx64 " cursor=0x%016" PRIx64 " base=0x%016" PRIx64
+           " top=0x%" PRIx64 "%016" PRIx64 " perms=0x%" PRIx32 "%s\n",
+           (uint64_t)(granule * 2 * sizeof(cc128_addr_t)), cap->cr_pesbt, cap->_cr_cursor, cap->cr_base,
+           (uint64_t)(top >> 64), (uint64_t)top, cc128_get_perms(cap), cap->cr_bounds_valid ? "" : " (invalid bounds)");
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s IMAGE TAGS\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    size_t image_size, tags_size;
+    const void* image = map_file(argv[1], &image_size);
+    const uint64_t* tags = (const uint64_t*)map_file(argv[2], &tags_size);
+    size_t granules = image_size / (2 * sizeof(cc128_addr_t));
+    // The scanner reads whole 64-bit words of the tag bitmap.
+    if (tags_size / sizeof(uint64_t) < (granules + 63) / 64) {
+        errx(EX_DATAERR, "%s is too small for the %zu granules in %s (need %zu bytes)", argv[2], granules, argv[1],
+             (granules + 63) / 64 * sizeof(uint64_t));
+    }
+    size_t found = cc128_scan_tagged_mem(image, tags, granules, print_cap, NULL);
+    fprintf(stderr, "%zu of %zu granules tagged\n", found, granules);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,63 @@
+#ifndef _TEST_ALIGNMENT_MASK_H
+#define _TEST_ALIGNMENT_MASK_H
+
+#include <vector>
+
+/*
+ * Checks for the closed-form CRAM/CRRL implementation against the mask that
+ * setbounds_impl() computes on a maximum permissions capability.
+ */
+
+static _cc_addr_t setbounds_alignment_mask(_cc_addr_t req_length) {
+    _cc_cap_t tmpcap = _cc_N(make_max_perms_cap)(0, 0, _CC_MAX_TOP);
+    _cc_addr_t mask = 0;
+    _cc_N(setbounds_impl)(&tmpcap, req_length, &mask);
+    return mask;
+}
+
+static std::vector<_cc_addr_t> alignment_mask_test_lengths() {
+    std::vector<_cc_addr_t> lengths;
+    // Values around every power of two exercise each exponent and the mantissa overflow case.
+    for (unsigned bit = 0; bit < _CC_ADDR_WIDTH; bit++) {
+        _cc_addr_t pow2 = (_cc_addr_t)1 << bit;
+        for (_cc_addr_t delta = 0; delta < 5; delta++) {
+            lengths.push_back(pow2 + delta);
+            lengths.push_back(pow2 - delta);
+        }
+        lengths.push_back(pow2 | (pow2 >> 1));
+        lengths.push_back(pow2 | (pow2 - 1));
+    }
+    uint64_t rng = 0x9e3779b97f4a7c15;
+    for (int i = 0; i < 10000; i++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        lengths.push_back((_cc_addr_t)rng >> (rng % _CC_ADDR_WIDTH));
+    }
+    lengths.push_back(_CC_MAX_ADDR);
+    return lengths;
+}
+
+TEST_CASE("Closed-form CRAM matches setbounds", "[cram]") {
+    for (_cc_addr_t len : alignment_mask_test_lengths()) {
+        CAPTURE(len);
+        _cc_addr_t mask = _cc_N(get_alignment_mask)(len);
+        CHECK(mask == setbounds_alignment_mask(len));
+        CHECK(_cc_N(get_representable_length)(len) == ((len + ~mask) & mask));
+    }
+}
+
+TEST_CASE("Batch CRAM/CRRL match scalar versions", "[cram][batch]") {
+    std::vector<_cc_addr_t> lengths = alignment_mask_test_lengths();
+    std::vector<_cc_addr_t> masks(lengths.size());
+    std::vector<_cc_addr_t> rep_lengths(lengths.size());
+    CompressedCapCC::representable_mask_batch(lengths.data(), lengths.size(), masks.data());
+    CompressedCapCC::representable_length_batch(lengths.data(), lengths.size(), rep_lengths.data());
+    for (size_t i = 0; i < lengths.size(); i++) {
+        CAPTURE(i, lengths[i]);
+        CHECK(masks[i] == _cc_N(get_alignment_mask)(lengths[i]));
+        CHECK(rep_lengths[i] == _cc_N(get_representable_length)(lengths[i]));
+    }
+}
+
+#endif // _TEST_ALIGNMENT_MASK_H
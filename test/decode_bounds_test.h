@@ -0,0 +1,119 @@
+#ifndef _TEST_DECODE_BOUNDS_H
+#define _TEST_DECODE_BOUNDS_H
+
+#include <vector>
+
+/*
+ * Checks for the bounds-only decode functions against the full decompression
+ * path. Expects the including file to provide the inputs[] array from
+ * decode_inputs_<N>.cpp.
+ */
+
+TEST_CASE("Bounds-only decode matches full decompression", "[decode]") {
+    for (size_t i = 0; i < array_lengthof(inputs); i++) {
+        CAPTURE(i, inputs[i].pesbt, inputs[i].cursor);
+        CompressedCapCC::cap_t full = CompressedCapCC::decompress_raw(inputs[i].pesbt, inputs[i].cursor, false);
+        CompressedCapCC::addr_t base = 0;
+        CompressedCapCC::length_t top = 0;
+        uint8_t exp = 0;
+        bool valid = _cc_N(decode_bounds)(inputs[i].pesbt, inputs[i].cursor, &base, &top, &exp);
+        CHECK(valid == full.cr_bounds_valid);
+        CHECK(base == full.cr_base);
+        CHECK(top == full._cr_top);
+        CHECK(exp == full.cr_exp);
+        // The _mem variant applies the NULL XOR mask first.
+        CompressedCapCC::addr_t mem_base = 0;
+        CompressedCapCC::length_t mem_top = 0;
+        bool mem_valid = CompressedCapCC::decode_bounds_mem(inputs[i].pesbt ^ _CC_N(NULL_XOR_MASK), inputs[i].cursor,
+                                                            &mem_base, &mem_top);
+        CHECK(mem_valid == valid);
+        CHECK(mem_base == base);
+        CHECK(mem_top == top);
+    }
+}
+
+TEST_CASE("Cached bounds decode matches uncached decode", "[decode]") {
+    _cc_bounds_cache_t cache;
+    _cc_N(bounds_cache_init)(&cache);
+    uint64_t lookups = 0;
+    for (size_t i = 0; i < array_lengthof(inputs); i++) {
+        // The cache key only includes the EBT bits, so nothing else may affect the bounds.
+        REQUIRE(CompressedCapCC::extract_bounds_bits(inputs[i].pesbt) ==
+                CompressedCapCC::extract_bounds_bits(inputs[i].pesbt & _CC_N(FIELD_EBT_MASK64)));
+        // Nearby cursors usually share a cache entry, distant ones should not.
+        const CompressedCapCC::addr_t cursors[] = {
+            inputs[i].cursor, inputs[i].cursor + 1, inputs[i].cursor ^ 0x100,
+            inputs[i].cursor ^ ((CompressedCapCC::addr_t)1 << (_CC_ADDR_WIDTH - 5)), inputs[i].cursor};
+        for (CompressedCapCC::addr_t cursor : cursors) {
+            CAPTURE(i, inputs[i].pesbt, cursor);
+            CompressedCapCC::addr_t base = 0, cached_base = 0;
+            CompressedCapCC::length_t top = 0, cached_top = 0;
+            uint8_t exp = 0, cached_exp = 0;
+            bool valid = _cc_N(decode_bounds)(inputs[i].pesbt, cursor, &base, &top, &exp);
+            bool cached_valid =
+                _cc_N(decode_bounds_cached)(&cache, inputs[i].pesbt, cursor, &cached_base, &cached_top, &cached_exp);
+            lookups++;
+            CHECK(cached_valid == valid);
+            CHECK(cached_base == base);
+            CHECK(cached_top == top);
+            CHECK(cached_exp == exp);
+        }
+    }
+    CHECK(cache.hits + cache.misses == lookups);
+    // Repeating the same lookup must hit.
+    CHECK(cache.hits >= array_lengthof(inputs));
+}
+
+TEST_CASE("Lazily decoded capabilities match full decompression", "[decode]") {
+    for (size_t i = 0; i < array_lengthof(inputs); i++) {
+        CAPTURE(i, inputs[i].pesbt, inputs[i].cursor);
+        CompressedCapCC::cap_t full = CompressedCapCC::decompress_raw(inputs[i].pesbt, inputs[i].cursor, false);
+        LazyCap<CompressedCapCC> lazy = LazyCap<CompressedCapCC>::from_raw(inputs[i].pesbt, inputs[i].cursor, false);
+        LazyCap<CompressedCapCC> copy = lazy;
+        CHECK(copy == lazy);
+        CHECK(lazy.address() == full.address());
+        CHECK(lazy.permissions() == full.permissions());
+        CHECK(lazy.base() == full.base());
+        CHECK(lazy.top() == full.top());
+        CHECK(lazy.bounds_valid() == (bool)full.cr_bounds_valid);
+        // Accessing memoized values again must return the same results.
+        CHECK(lazy.top() == full.top());
+        CHECK(lazy.permissions() == full.permissions());
+        CHECK(copy.length() == full.length());
+        CompressedCapCC::cap_t decompressed = lazy.decompress();
+        CHECK(memcmp(&decompressed, &full, sizeof(full)) == 0);
+        LazyCap<CompressedCapCC> from_mem =
+            LazyCap<CompressedCapCC>::from_mem(inputs[i].pesbt ^ _CC_N(NULL_XOR_MASK), inputs[i].cursor, false);
+        CHECK(from_mem == lazy);
+        CHECK(from_mem != LazyCap<CompressedCapCC>::from_raw(inputs[i].pesbt, inputs[i].cursor, true));
+    }
+}
+
+TEST_CASE("Batch bounds decode matches scalar path", "[decode][batch]") {
+    const size_t count = array_lengthof(inputs);
+    std::vector<_cc_addr_t> pesbts(count), cursors(count), bases(count), tops_lo(count);
+    std::vector<uint8_t> tops_hi(count), exps(count);
+    std::vector<uint8_t> valid(count);
+    for (size_t i = 0; i < count; i++) {
+        pesbts[i] = inputs[i].pesbt;
+        cursors[i] = inputs[i].cursor;
+    }
+    // Use an odd count to also exercise the scalar remainder of the vectorized loop.
+    const size_t batch_count = count - 1;
+    _cc_N(compute_base_top_batch)(pesbts.data(), cursors.data(), batch_count, bases.data(), tops_lo.data(),
+                                  tops_hi.data(), exps.data(), valid.data());
+    for (size_t i = 0; i < batch_count; i++) {
+        CAPTURE(i, pesbts[i], cursors[i]);
+        _cc_bounds_bits bounds = _cc_N(extract_bounds_bits)(pesbts[i]);
+        _cc_addr_t base;
+        _cc_length_t top;
+        bool scalar_valid = _cc_N(compute_base_top)(bounds, cursors[i], &base, &top);
+        REQUIRE(valid[i] == (uint8_t)scalar_valid);
+        REQUIRE(bases[i] == base);
+        REQUIRE(tops_lo[i] == (_cc_addr_t)top);
+        REQUIRE(tops_hi[i] == (uint8_t)(top >> _CC_ADDR_WIDTH));
+        REQUIRE(exps[i] == (uint8_t)bounds.E);
+    }
+}
+
+#endif
@@ -140,3 +140,5 @@ TEST_CASE("Check sail-generated inputs decode correctly", "[decode]") {
     }
     REQUIRE(failure_count == 0);
 }
+
+#include "decode_bounds_test.h"
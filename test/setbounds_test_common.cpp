@@ -2,6 +2,7 @@
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 
 #include "test_common.cpp"
 #include <catch2/matchers/catch_matchers_exception.hpp>
@@ -349,3 +350,46 @@ TEST_CASE("Setbounds top greater max", "[fuzz]") {
     CHECK(result.address() == _CC_MAX_ADDR);
     CHECK(result.top() == _CC_MAX_ADDR);
 }
+
+TEST_CASE("Batch setbounds matches setbounds", "[bounds][batch]") {
+    TestAPICC::cap_t sealed = TestAPICC::make_max_perms_cap(0x10000, 0x10000, 0x20000);
+    _cc_N(update_otype)(&sealed, 5);
+    const TestAPICC::cap_t parents[] = {
+        TestAPICC::make_max_perms_cap(0, 0, _CC_MAX_TOP),
+        TestAPICC::make_max_perms_cap(0x10000, 0x10000, 0x20000),
+        TestAPICC::make_null_derived_cap(0x1000),
+        sealed,
+    };
+    const size_t count = 512;
+    std::vector<TestAPICC::addr_t> bases(count);
+    std::vector<TestAPICC::length_t> lens(count);
+    uint64_t rng = 0x9e3779b97f4a7c15;
+    for (size_t i = 0; i < count; i++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        // Mix bases inside the smaller parent with arbitrary ones and lengths spread over all exponents.
+        bases[i] = i % 2 ? (TestAPICC::addr_t)(0x10000 + (rng & 0xffff)) : (TestAPICC::addr_t)(rng * 0x9e37);
+        lens[i] = (TestAPICC::addr_t)rng >> ((rng >> 32) % _CC_ADDR_WIDTH);
+    }
+    for (const TestAPICC::cap_t& parent : parents) {
+        CAPTURE(parent);
+        std::vector<TestAPICC::cap_t> out(count);
+        std::vector<uint8_t> exact(count);
+        TestAPICC::setbounds_batch(parent, bases.data(), lens.data(), count, out.data(), exact.data());
+        for (size_t i = 0; i < count; i++) {
+            CAPTURE(i, bases[i], lens[i]);
+            TestAPICC::cap_t expected = parent;
+            TestAPICC::set_addr(&expected, bases[i]);
+            bool expected_exact = TestAPICC::setbounds(&expected, lens[i]);
+            CHECK((bool)exact[i] == expected_exact);
+            CHECK(out[i].cr_tag == expected.cr_tag);
+            CHECK(out[i].address() == expected.address());
+            CHECK(out[i].cr_pesbt == expected.cr_pesbt);
+            CHECK(out[i].base() == expected.base());
+            CHECK(out[i].top() == expected.top());
+            CHECK(out[i].cr_exp == expected.cr_exp);
+            CHECK(out[i].cr_bounds_valid == expected.cr_bounds_valid);
+        }
+    }
+}
@@ -4,6 +4,9 @@
 
 #include "test_common.cpp"
 #include "cap_m_ap.h"
+#include "decode_inputs_128.cpp"
+#include "decode_bounds_test.h"
+#include "alignment_mask_test.h"
 
 TEST_CASE("update ct", "[ct]") {
     _cc_cap_t cap;
@@ -1,4 +1,5 @@
 #include "test_common.cpp"
+#include <vector>
 
 // Due to magic constant XOR aversion (i.e. fields are either entirely
 // inverted or not at all, rather than select bits within them like in
@@ -208,3 +209,177 @@ TEST_CASE("pesbt_is_correct ignores cr_extra", "") {
     null_cap.cr_extra = 10;
     CHECK(_cc_N(pesbt_is_correct)(&null_cap));
 }
+
+TEST_CASE("Batch decompression matches decompress_mem", "[batch]") {
+    const TestAPICC::cap_t caps[] = {
+        TestAPICC::make_null_derived_cap(0),
+        TestAPICC::make_null_derived_cap(0x1234),
+        TestAPICC::make_max_perms_cap(0, 0, _CC_MAX_TOP),
+        TestAPICC::make_max_perms_cap(0x1000, 0x1010, 0x2000),
+        TestAPICC::make_max_perms_cap(0x401ffff8, 0x401ffff8, 0x40200000),
+    };
+    const size_t num_caps = array_lengthof(caps);
+    // Also include some arbitrary (untagged) bit patterns.
+    const _cc_addr_t extra_pesbt[] = {(_cc_addr_t)UINT64_C(0x305BDE7F5C0B8919), (_cc_addr_t)UINT64_C(0x6D78585424BEE4CC),
+                                      (_cc_addr_t)UINT64_C(0x19249C8A5C66D2A3)};
+    const _cc_addr_t extra_cursor[] = {(_cc_addr_t)UINT64_C(0x47B6516348F5CCD3), (_cc_addr_t)UINT64_C(0x968A907B906DBBF5),
+                                       (_cc_addr_t)UINT64_C(0x849B1CD05BDCAED9)};
+    const size_t count = num_caps + array_lengthof(extra_pesbt);
+    _cc_addr_t pesbts[count];
+    _cc_addr_t cursors[count];
+    uint64_t tags[1] = {0};
+    for (size_t i = 0; i < count; i++) {
+        if (i < num_caps) {
+            pesbts[i] = _cc_N(compress_mem)(&caps[i]);
+            cursors[i] = caps[i].address();
+            tags[0] |= (uint64_t)caps[i].cr_tag << i;
+        } else {
+            pesbts[i] = extra_pesbt[i - num_caps];
+            cursors[i] = extra_cursor[i - num_caps];
+        }
+    }
+    TestAPICC::cap_t batch[count];
+    memset(batch, 'b', sizeof(batch));
+    TestAPICC::decompress_mem_batch(pesbts, cursors, tags, count, batch);
+    for (size_t i = 0; i < count; i++) {
+        CAPTURE(i);
+        TestAPICC::cap_t expected;
+        _cc_N(decompress_mem)(pesbts[i], cursors[i], _cc_N(tag_bitmap_get)(tags, i), &expected);
+        CHECK(memcmp(&expected, &batch[i], sizeof(expected)) == 0);
+        CHECK(batch[i].cr_tag == (i < num_caps ? caps[i].cr_tag : 0));
+    }
+    // A NULL tag bitmap decodes everything as untagged.
+    _cc_N(decompress_mem_batch)(pesbts, cursors, NULL, count, batch);
+    for (size_t i = 0; i < count; i++) {
+        TestAPICC::cap_t expected;
+        _cc_N(decompress_mem)(pesbts[i], cursors[i], false, &expected);
+        CHECK(memcmp(&expected, &batch[i], sizeof(expected)) == 0);
+    }
+}
+
+TEST_CASE("Capability table decode/encode round trip", "[batch]") {
+    const TestAPICC::cap_t caps[] = {
+        TestAPICC::make_null_derived_cap(0x1234),
+        TestAPICC::make_max_perms_cap(0, 0, _CC_MAX_TOP),
+        TestAPICC::make_max_perms_cap(0x1000, 0x1010, 0x2000),
+        TestAPICC::make_max_perms_cap(0x401ffff8, 0x401ffff8, 0x40200000),
+    };
+    // Decode a range that crosses a bitmap word boundary.
+    const size_t count = 80;
+    const size_t start = 60;
+    _cc_addr_t pesbts[count];
+    _cc_addr_t cursors[count];
+    uint64_t tags[2] = {0, 0};
+    uint64_t rng = 0x9e3779b97f4a7c15;
+    for (size_t i = 0; i < count; i++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        if (i % 3 == 0) {
+            const TestAPICC::cap_t& cap = caps[(i / 3) % array_lengthof(caps)];
+            pesbts[i] = _cc_N(compress_mem)(&cap);
+            cursors[i] = cap.address();
+            _cc_N(tag_bitmap_set)(tags, i, cap.cr_tag);
+        } else {
+            // Arbitrary untagged bit patterns.
+            pesbts[i] = (_cc_addr_t)rng;
+            cursors[i] = (_cc_addr_t)(rng >> 17) * 0x1f;
+        }
+    }
+    _cc_cap_table_t table;
+    REQUIRE(_cc_N(cap_table_init)(&table, start + count + 5));
+    _cc_N(cap_table_decode_mem)(&table, start, pesbts, cursors, tags, count);
+    for (size_t i = 0; i < count; i++) {
+        CAPTURE(i);
+        TestAPICC::cap_t expected;
+        _cc_N(decompress_mem)(pesbts[i], cursors[i], _cc_N(tag_bitmap_get)(tags, i), &expected);
+        CHECK(table.base[start + i] == expected.cr_base);
+        CHECK(_cc_N(cap_table_top)(&table, start + i) == expected._cr_top);
+        CHECK(table.exponent[start + i] == expected.cr_exp);
+        CHECK(_cc_N(cap_table_tag)(&table, start + i) == expected.cr_tag);
+        TestAPICC::cap_t row;
+        _cc_N(cap_table_get)(&table, start + i, &row);
+        CHECK(memcmp(&expected, &row, sizeof(expected)) == 0);
+    }
+    // Rows outside the decoded range are untouched.
+    CHECK(table.pesbt[start - 1] == 0);
+    CHECK(!_cc_N(cap_table_tag)(&table, start + count));
+
+    _cc_addr_t encoded_pesbts[count];
+    _cc_addr_t encoded_cursors[count];
+    uint64_t encoded_tags[2] = {~UINT64_C(0), ~UINT64_C(0)};
+    _cc_N(cap_table_encode_mem)(&table, start, count, encoded_pesbts, encoded_cursors, encoded_tags);
+    CHECK(memcmp(pesbts, encoded_pesbts, sizeof(pesbts)) == 0);
+    CHECK(memcmp(cursors, encoded_cursors, sizeof(cursors)) == 0);
+    for (size_t i = 0; i < count; i++) {
+        CHECK(_cc_N(tag_bitmap_get)(encoded_tags, i) == _cc_N(tag_bitmap_get)(tags, i));
+    }
+
+    // Storing an individual capability updates all columns.
+    _cc_N(cap_table_set)(&table, 0, &caps[1]);
+    TestAPICC::cap_t row;
+    _cc_N(cap_table_get)(&table, 0, &row);
+    CHECK(_cc_N(raw_equal)(&caps[1], &row));
+    CHECK(_cc_N(cap_table_top)(&table, 0) == caps[1]._cr_top);
+    _cc_N(cap_table_free)(&table);
+}
+
+struct ScannedCap {
+    size_t granule;
+    TestAPICC::cap_t cap;
+};
+
+static bool collect_scanned_cap(void* ctx, size_t granule, const _cc_cap_t* cap) {
+    static_cast<std::vector<ScannedCap>*>(ctx)->push_back({granule, *cap});
+    return true;
+}
+
+TEST_CASE("Tagged memory scan visits only tagged granules", "[scan]") {
+    const TestAPICC::cap_t caps[] = {
+        TestAPICC::make_max_perms_cap(0, 0, _CC_MAX_TOP),
+        TestAPICC::make_max_perms_cap(0x1000, 0x1010, 0x2000),
+        TestAPICC::make_max_perms_cap(0x401ffff8, 0x401ffff8, 0x40200000),
+    };
+    const size_t granules = 150;
+    const size_t tagged[] = {0, 3, 63, 64, 130, 149};
+    std::vector<_cc_addr_t> image(granules * 2, (_cc_addr_t)0xa5a5a5a5a5a5a5a5);
+    // Bits past the end of the image must be ignored.
+    uint64_t tags[3] = {0, 0, ~UINT64_C(0) << (granules % 64)};
+    for (size_t i = 0; i < array_lengthof(tagged); i++) {
+        const TestAPICC::cap_t& cap = caps[i % array_lengthof(caps)];
+        image[tagged[i] * 2] = cap.address();
+        image[tagged[i] * 2 + 1] = _cc_N(compress_mem)(&cap);
+        _cc_N(tag_bitmap_set)(tags, tagged[i], true);
+    }
+    std::vector<ScannedCap> scanned;
+    size_t visited = TestAPICC::scan_tagged_mem(image.data(), tags, granules, collect_scanned_cap, &scanned);
+    CHECK(visited == array_lengthof(tagged));
+    REQUIRE(scanned.size() == array_lengthof(tagged));
+    for (size_t i = 0; i < array_lengthof(tagged); i++) {
+        CAPTURE(i);
+        CHECK(scanned[i].granule == tagged[i]);
+        CHECK(scanned[i].cap.cr_tag);
+        CHECK(_cc_N(raw_equal)(&scanned[i].cap, &caps[i % array_lengthof(caps)]));
+    }
+
+    // The iterator form can be resumed and stops at the end of the image.
+    _cc_tag_scanner_t scanner;
+    _cc_N(tag_scanner_init)(&scanner, image.data(), tags, 64);
+    size_t granule = 0;
+    TestAPICC::cap_t cap;
+    REQUIRE(_cc_N(tag_scanner_next)(&scanner, &granule, &cap));
+    CHECK(granule == 0);
+    REQUIRE(_cc_N(tag_scanner_next)(&scanner, &granule, &cap));
+    CHECK(granule == 3);
+    REQUIRE(_cc_N(tag_scanner_next)(&scanner, &granule, &cap));
+    CHECK(granule == 63);
+    CHECK(!_cc_N(tag_scanner_next)(&scanner, &granule, &cap));
+    CHECK(!_cc_N(tag_scanner_next)(&scanner, &granule, &cap));
+
+    // Returning false from the callback stops the scan.
+    visited = _cc_N(scan_tagged_mem)(image.data(), tags, granules,
+                                     [](void*, size_t, const _cc_cap_t*) { return false; }, nullptr);
+    CHECK(visited == 1);
+}
+
+#include "alignment_mask_test.h"